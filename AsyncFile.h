@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "DynamicArray.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ASYNC_FILE_POSIX
+#include <sys/uio.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define ASYNC_FILE_IO_URING
+#endif
+#endif
+
+/*
+* Asynchronous saving and loading of array contents.
+*
+* The buffer is split into chunks which are written or read by a background thread, so the caller
+* continues immediately and collects the result from an IoHandle. On Linux the chunks are submitted
+* through io_uring and many of them are in flight at once. Where io_uring is not available, or the
+* kernel refuses it, the chunks are transferred one by one with pread() and pwrite().
+*/
+
+//! Buffers and chunks of O_DIRECT transfers must be aligned to that many bytes
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+//! Settings of an asynchronous transfer
+struct IoOptions
+{
+	size_t chunkSize = (size_t)1 << 20; //!< Bytes per request
+	unsigned queueDepth = 32;           //!< Requests in flight with io_uring
+	bool direct = false;                //!< Bypass the page cache with O_DIRECT. Needs an aligned buffer and chunk size
+	bool useIoUring = true;             //!< False forces the synchronous fallback
+};
+
+#ifdef ASYNC_FILE_IO_URING
+//! Minimal io_uring instance with its submission and completion rings mapped in memory
+class IoRing
+{
+public:
+
+	//! Creates a ring with room for the given number of requests. Check isOpen() for success
+	explicit IoRing(unsigned entries);
+	IoRing(const IoRing&) = delete;
+	IoRing& operator=(const IoRing&) = delete;
+	~IoRing();
+
+	//! Check if the kernel created the ring
+	bool isOpen() const;
+	//! Return the number of requests the submission ring holds
+	unsigned getEntries() const;
+
+	//! Adds a readv or writev request of one vector. The submission ring must have room for it
+	void queue(bool write, int fd, const iovec* vector, uint64_t offset, uint64_t userData);
+	//! Submits the queued requests and waits for at least one completion
+	void submitAndWait();
+	//! Takes a completion if there is one. result is the number of bytes or a negative errno
+	bool reap(uint64_t& userData, int& result);
+
+private:
+
+	// Kernel interface, defined in AsyncFile.ipp so that <linux/io_uring.h> is not needed
+	struct Kernel;
+	struct SubmissionEntry;
+	struct CompletionEntry;
+
+	//! Unmaps the rings and closes the ring descriptor
+	void release();
+
+	// Class members:
+
+	int ringFd;
+	unsigned entries;
+	unsigned queued; //!< Requests added since the last submission
+
+	void* sqMemory;
+	size_t sqSize;
+	void* cqMemory;
+	size_t cqSize;
+	SubmissionEntry* sqes;
+	size_t sqesSize;
+
+	unsigned* sqTail;
+	unsigned* sqMask;
+	unsigned* sqArray;
+	unsigned* cqHead;
+	unsigned* cqTail;
+	unsigned* cqMask;
+	CompletionEntry* cqes;
+};
+#endif
+
+/**
+* \brief Completion handle of an asynchronous transfer
+*
+* The buffer of the transfer must stay alive and unchanged until the transfer is done.
+* The destructor waits for it.
+*/
+class IoHandle
+{
+public:
+
+	//! Handle of no transfer, which is already done
+	IoHandle();
+	IoHandle(IoHandle&& other);
+	IoHandle& operator=(IoHandle&& other);
+	IoHandle(const IoHandle&) = delete;
+	IoHandle& operator=(const IoHandle&) = delete;
+	~IoHandle();
+
+	/**
+	* \brief Wait for the transfer to finish
+	*
+	* If the transfer failed, throws a runtime_error exception with the reason
+	*/
+	void wait();
+
+	//! Check if the transfer has finished, successfully or not
+	bool isDone() const;
+
+	//! Return the number of bytes transferred. Valid once the transfer is done
+	size_t getBytes() const;
+	//! Return the duration of the transfer in seconds. Valid once the transfer is done
+	double getSeconds() const;
+	//! Return the achieved throughput in bytes per second. Valid once the transfer is done
+	double getThroughput() const;
+	//! Check if the transfer went through io_uring. Valid once the transfer is done
+	bool usedIoUring() const;
+
+	//! Starts transferring bytes between the buffer and the file in a background thread
+	static IoHandle start(bool write, const std::string& path, char* buffer, size_t bytes, const IoOptions& options);
+
+private:
+
+	//! Shared with the background thread
+	struct State
+	{
+		std::atomic<bool> done{ false };
+		std::string error;
+		size_t bytes = 0;
+		double seconds = 0;
+		bool ring = false;
+	};
+
+	//! Body of the background thread
+	static void run(bool write, std::string path, char* buffer, size_t bytes, IoOptions options, State* state);
+	//! Transfers [begin, end) of the buffer at the same offsets of the file, with io_uring if it is open
+	static void transfer(bool write, int fd, char* buffer, size_t begin, size_t end, const IoOptions& options, bool& ring);
+#ifdef ASYNC_FILE_IO_URING
+	//! Keeps the ring filled with chunks of [begin, end) until all are done
+	static void transferRing(IoRing& uring, bool write, int fd, char* buffer, size_t begin, size_t end, size_t chunkSize);
+#endif
+	//! Joins the background thread
+	void finish();
+
+
+	// Class members:
+
+	std::unique_ptr<State> state;
+	std::thread worker;
+};
+
+/**
+* \brief Starts writing the elements of the array to a file
+*
+* The file is created or truncated. The array must not change until the transfer is done.
+*/
+template <class T, size_t Alignment>
+IoHandle saveAsync(const DynamicArray<T, Alignment>& arr, const std::string& path, const IoOptions& options = IoOptions());
+
+/**
+* \brief Starts reading the elements of the array from a file
+*
+* Resizes the array to the number of elements in the file before returning. The array must not
+* be used until the transfer is done. If the file size is not a multiple of the element size,
+* throws a runtime_error exception.
+*/
+template <class T, size_t Alignment>
+IoHandle loadAsync(DynamicArray<T, Alignment>& arr, const std::string& path, const IoOptions& options = IoOptions());
+
+//! Return the size of a file in bytes. If the file cannot be examined, throws a runtime_error exception
+size_t fileSize(const std::string& path);
+
+#include "AsyncFile.ipp"
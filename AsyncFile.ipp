@@ -0,0 +1,466 @@
+#include "AsyncFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef ASYNC_FILE_POSIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#ifdef ASYNC_FILE_IO_URING
+#include <sys/mman.h>
+
+//! Parameters and constants of io_uring_setup(), as laid out in <linux/io_uring.h>
+struct IoRing::Kernel
+{
+	struct SqOffsets
+	{
+		uint32_t head, tail, ring_mask, ring_entries, flags, dropped, array, resv1;
+		uint64_t user_addr;
+	};
+
+	struct CqOffsets
+	{
+		uint32_t head, tail, ring_mask, ring_entries, overflow, cqes, flags, resv1;
+		uint64_t user_addr;
+	};
+
+	struct Params
+	{
+		uint32_t sq_entries, cq_entries, flags, sq_thread_cpu, sq_thread_idle, features, wq_fd, resv[3];
+		SqOffsets sq_off;
+		CqOffsets cq_off;
+	};
+
+	static constexpr uint8_t OP_READV = 1;
+	static constexpr uint8_t OP_WRITEV = 2;
+	static constexpr unsigned ENTER_GETEVENTS = 1;
+	static constexpr uint32_t FEAT_SINGLE_MMAP = 1;
+	static constexpr off_t OFF_SQ_RING = 0;
+	static constexpr off_t OFF_CQ_RING = 0x8000000;
+	static constexpr off_t OFF_SQES = 0x10000000;
+};
+
+//! Submission queue entry, the fields of a readv or writev
+struct IoRing::SubmissionEntry
+{
+	uint8_t opcode;
+	uint8_t flags;
+	uint16_t ioprio;
+	int32_t fd;
+	uint64_t off;
+	uint64_t addr;
+	uint32_t len;
+	uint32_t rw_flags;
+	uint64_t user_data;
+	uint64_t pad[3];
+};
+
+//! Completion queue entry
+struct IoRing::CompletionEntry
+{
+	uint64_t user_data;
+	int32_t res;
+	uint32_t flags;
+};
+
+inline IoRing::IoRing(unsigned entries)
+	: ringFd(-1), entries(0), queued(0), sqMemory(MAP_FAILED), sqSize(0), cqMemory(MAP_FAILED), cqSize(0),
+	sqes((SubmissionEntry*)MAP_FAILED), sqesSize(0), sqTail(nullptr), sqMask(nullptr), sqArray(nullptr),
+	cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqes(nullptr)
+{
+	static_assert(sizeof(Kernel::Params) == 120, "Layout of struct io_uring_params");
+	static_assert(sizeof(SubmissionEntry) == 64, "Layout of struct io_uring_sqe");
+	static_assert(sizeof(CompletionEntry) == 16, "Layout of struct io_uring_cqe");
+
+	Kernel::Params params;
+	std::memset(&params, 0, sizeof(params));
+
+	ringFd = (int)syscall(__NR_io_uring_setup, entries, &params);
+	if (ringFd < 0)
+		return;
+
+	sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	cqSize = params.cq_off.cqes + params.cq_entries * sizeof(CompletionEntry);
+	bool single = (params.features & Kernel::FEAT_SINGLE_MMAP) != 0;
+	if (single)
+		sqSize = cqSize = std::max(sqSize, cqSize);
+
+	sqMemory = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, Kernel::OFF_SQ_RING);
+	cqMemory = single ? sqMemory : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, Kernel::OFF_CQ_RING);
+	sqesSize = params.sq_entries * sizeof(SubmissionEntry);
+	sqes = (SubmissionEntry*)mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, Kernel::OFF_SQES);
+
+	if (sqMemory == MAP_FAILED || cqMemory == MAP_FAILED || sqes == MAP_FAILED) {
+		release();
+		return;
+	}
+
+	char* sq = (char*)sqMemory;
+	char* cq = (char*)cqMemory;
+	sqTail = (unsigned*)(sq + params.sq_off.tail);
+	sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+	sqArray = (unsigned*)(sq + params.sq_off.array);
+	cqHead = (unsigned*)(cq + params.cq_off.head);
+	cqTail = (unsigned*)(cq + params.cq_off.tail);
+	cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+	cqes = (CompletionEntry*)(cq + params.cq_off.cqes);
+	this->entries = params.sq_entries;
+}
+
+inline IoRing::~IoRing()
+{
+	release();
+}
+
+inline bool IoRing::isOpen() const
+{
+	return ringFd >= 0;
+}
+
+inline unsigned IoRing::getEntries() const
+{
+	return entries;
+}
+
+inline void IoRing::queue(bool write, int fd, const iovec* vector, uint64_t offset, uint64_t userData)
+{
+	// Only this thread moves the tail, the kernel reads it
+	unsigned tail = *sqTail;
+	unsigned index = tail & *sqMask;
+
+	SubmissionEntry& sqe = sqes[index];
+	std::memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = write ? Kernel::OP_WRITEV : Kernel::OP_READV;
+	sqe.fd = fd;
+	sqe.addr = (uint64_t)(uintptr_t)vector;
+	sqe.len = 1;
+	sqe.off = offset;
+	sqe.user_data = userData;
+	sqArray[index] = index;
+
+	__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+	++queued;
+}
+
+inline void IoRing::submitAndWait()
+{
+	for (;;) {
+		int submitted = (int)syscall(__NR_io_uring_enter, ringFd, queued, 1, Kernel::ENTER_GETEVENTS, nullptr, 0);
+		if (submitted >= 0) {
+			queued -= submitted;
+			return;
+		}
+		if (errno != EINTR)
+			throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno) + "\n");
+	}
+}
+
+inline void IoRing::release()
+{
+	if (sqes != MAP_FAILED)
+		munmap(sqes, sqesSize);
+	if (cqMemory != MAP_FAILED && cqMemory != sqMemory)
+		munmap(cqMemory, cqSize);
+	if (sqMemory != MAP_FAILED)
+		munmap(sqMemory, sqSize);
+	if (ringFd >= 0)
+		close(ringFd);
+
+	ringFd = -1;
+	sqMemory = cqMemory = MAP_FAILED;
+	sqes = (SubmissionEntry*)MAP_FAILED;
+}
+
+inline bool IoRing::reap(uint64_t& userData, int& result)
+{
+	// Only this thread moves the head, the kernel moves the tail
+	unsigned head = *cqHead;
+	if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+		return false;
+
+	const CompletionEntry& cqe = cqes[head & *cqMask];
+	userData = cqe.user_data;
+	result = cqe.res;
+	__atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+#endif
+
+inline IoHandle::IoHandle()
+{
+}
+
+inline IoHandle::IoHandle(IoHandle&& other)
+	: state(std::move(other.state)), worker(std::move(other.worker))
+{
+}
+
+inline IoHandle& IoHandle::operator=(IoHandle&& other)
+{
+	if (this != &other) {
+		finish();
+		state = std::move(other.state);
+		worker = std::move(other.worker);
+	}
+
+	return *this;
+}
+
+inline IoHandle::~IoHandle()
+{
+	finish();
+}
+
+inline void IoHandle::wait()
+{
+	finish();
+	if (state && !state->error.empty())
+		throw std::runtime_error(state->error);
+}
+
+inline bool IoHandle::isDone() const
+{
+	return !state || state->done.load(std::memory_order_acquire);
+}
+
+inline size_t IoHandle::getBytes() const
+{
+	return state ? state->bytes : 0;
+}
+
+inline double IoHandle::getSeconds() const
+{
+	return state ? state->seconds : 0;
+}
+
+inline double IoHandle::getThroughput() const
+{
+	double seconds = getSeconds();
+	return seconds > 0 ? getBytes() / seconds : 0;
+}
+
+inline bool IoHandle::usedIoUring() const
+{
+	return state && state->ring;
+}
+
+inline IoHandle IoHandle::start(bool write, const std::string& path, char* buffer, size_t bytes, const IoOptions& options)
+{
+	if (options.chunkSize == 0)
+		throw std::invalid_argument("Chunk size must be positive\n");
+	if (options.direct && ((uintptr_t)buffer % DIRECT_IO_ALIGNMENT != 0 || options.chunkSize % DIRECT_IO_ALIGNMENT != 0))
+		throw std::invalid_argument("Direct transfers need a buffer and chunk size aligned to DIRECT_IO_ALIGNMENT\n");
+
+	IoHandle handle;
+	handle.state.reset(new State);
+	handle.worker = std::thread(&IoHandle::run, write, path, buffer, bytes, options, handle.state.get());
+	return handle;
+}
+
+inline void IoHandle::run(bool write, std::string path, char* buffer, size_t bytes, IoOptions options, State* state)
+{
+	auto begin = std::chrono::steady_clock::now();
+	bool ring = false;
+
+	try {
+#ifdef ASYNC_FILE_POSIX
+		int fd = ::open(path.c_str(), (write ? O_WRONLY | O_CREAT | O_TRUNC : O_RDONLY) | O_CLOEXEC, 0644);
+		if (fd < 0)
+			throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno) + "\n");
+
+		// Whole blocks go through a second descriptor opened with O_DIRECT, the unaligned tail through the first.
+		// File systems without O_DIRECT support refuse to open it, and then everything is buffered
+		int directFd = -1;
+		size_t directEnd = 0;
+#ifdef O_DIRECT
+		if (options.direct) {
+			directFd = ::open(path.c_str(), (write ? O_WRONLY : O_RDONLY) | O_CLOEXEC | O_DIRECT);
+			if (directFd >= 0)
+				directEnd = bytes / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+		}
+#endif
+
+		try {
+			transfer(write, directFd, buffer, 0, directEnd, options, ring);
+			transfer(write, fd, buffer, directEnd, bytes, options, ring);
+		}
+		catch (...) {
+			if (directFd >= 0)
+				close(directFd);
+			close(fd);
+			throw;
+		}
+
+		if (directFd >= 0)
+			close(directFd);
+		if (close(fd) != 0)
+			throw std::runtime_error("Cannot close " + path + ": " + std::strerror(errno) + "\n");
+#else
+		std::FILE* file = std::fopen(path.c_str(), write ? "wb" : "rb");
+		if (!file)
+			throw std::runtime_error("Cannot open " + path + "\n");
+
+		for (size_t offset = 0; offset < bytes; ) {
+			size_t length = std::min(options.chunkSize, bytes - offset);
+			size_t done = write ? std::fwrite(buffer + offset, 1, length, file) : std::fread(buffer + offset, 1, length, file);
+			if (done == 0) {
+				std::fclose(file);
+				throw std::runtime_error(write ? "Write failed\n" : "Unexpected end of file\n");
+			}
+			offset += done;
+		}
+
+		if (std::fclose(file) != 0)
+			throw std::runtime_error("Cannot close " + path + "\n");
+#endif
+		state->bytes = bytes;
+	}
+	catch (const std::exception& e) {
+		state->error = e.what();
+	}
+
+	state->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	state->ring = ring;
+	state->done.store(true, std::memory_order_release);
+}
+
+inline void IoHandle::transfer(bool write, int fd, char* buffer, size_t begin, size_t end, const IoOptions& options, bool& ring)
+{
+	if (begin == end)
+		return;
+
+#ifdef ASYNC_FILE_IO_URING
+	if (options.useIoUring) {
+		IoRing uring(std::max(options.queueDepth, 1u));
+		if (uring.isOpen()) {
+			ring = true;
+			transferRing(uring, write, fd, buffer, begin, end, options.chunkSize);
+			return;
+		}
+	}
+#endif
+
+#ifdef ASYNC_FILE_POSIX
+	for (size_t offset = begin; offset < end; ) {
+		size_t length = std::min(options.chunkSize, end - offset);
+		ssize_t done = write ? pwrite(fd, buffer + offset, length, (off_t)offset) : pread(fd, buffer + offset, length, (off_t)offset);
+		if (done < 0 && errno == EINTR)
+			continue;
+		if (done < 0)
+			throw std::runtime_error(std::string("Transfer failed: ") + std::strerror(errno) + "\n");
+		if (done == 0)
+			throw std::runtime_error("Unexpected end of file\n");
+		offset += done;
+	}
+#else
+	(void)write; (void)fd; (void)buffer; (void)options; (void)ring;
+#endif
+}
+
+#ifdef ASYNC_FILE_IO_URING
+inline void IoHandle::transferRing(IoRing& uring, bool write, int fd, char* buffer, size_t begin, size_t end, size_t chunkSize)
+{
+	// Each slot holds one request. Short transfers are queued again for the rest of their chunk
+	std::vector<iovec> vectors(uring.getEntries());
+	std::vector<uint64_t> freeSlots;
+	for (uint64_t slot = vectors.size(); slot > 0; --slot)
+		freeSlots.push_back(slot - 1);
+
+	size_t next = begin;
+	size_t inFlight = 0;
+	std::string failure;
+
+	// After a failure nothing new is queued, but the requests in flight are still collected
+	// because the kernel uses the buffer until they complete
+	while (inFlight > 0 || (next < end && failure.empty())) {
+		for (; !freeSlots.empty() && next < end && failure.empty(); ++inFlight) {
+			uint64_t slot = freeSlots.back();
+			freeSlots.pop_back();
+
+			size_t length = std::min(chunkSize, end - next);
+			vectors[slot].iov_base = buffer + next;
+			vectors[slot].iov_len = length;
+			uring.queue(write, fd, &vectors[slot], next, slot);
+			next += length;
+		}
+
+		uring.submitAndWait();
+
+		uint64_t slot;
+		int result;
+		while (uring.reap(slot, result)) {
+			--inFlight;
+			iovec& vector = vectors[slot];
+
+			bool shortTransfer = result > 0 && (size_t)result < vector.iov_len;
+			if (shortTransfer) {
+				vector.iov_base = (char*)vector.iov_base + result;
+				vector.iov_len -= result;
+			}
+
+			if (shortTransfer || result == -EAGAIN || result == -EINTR) {
+				uring.queue(write, fd, &vector, (char*)vector.iov_base - buffer, slot);
+				++inFlight;
+				continue;
+			}
+
+			if (result <= 0 && failure.empty())
+				failure = result < 0 ? std::string("Transfer failed: ") + std::strerror(-result) + "\n" : "Unexpected end of file\n";
+			freeSlots.push_back(slot);
+		}
+	}
+
+	if (!failure.empty())
+		throw std::runtime_error(failure);
+}
+#endif
+
+inline void IoHandle::finish()
+{
+	if (worker.joinable())
+		worker.join();
+}
+
+inline size_t fileSize(const std::string& path)
+{
+#ifdef _WIN32
+	struct _stat64 info;
+	if (_stat64(path.c_str(), &info) != 0)
+		throw std::runtime_error("Cannot open " + path + "\n");
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		throw std::runtime_error("Cannot open " + path + "\n");
+#endif
+	return (size_t)info.st_size;
+}
+
+template <class T, size_t Alignment>
+inline IoHandle saveAsync(const DynamicArray<T, Alignment>& arr, const std::string& path, const IoOptions& options)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Elements are saved as raw bytes");
+
+	return IoHandle::start(true, path, (char*)arr.getData(), arr.getSize() * sizeof(T), options);
+}
+
+template <class T, size_t Alignment>
+inline IoHandle loadAsync(DynamicArray<T, Alignment>& arr, const std::string& path, const IoOptions& options)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Elements are loaded as raw bytes");
+
+	size_t bytes = fileSize(path);
+	if (bytes % sizeof(T) != 0)
+		throw std::runtime_error("File size is not a multiple of the element size\n");
+
+	arr.resize(bytes / sizeof(T));
+	return IoHandle::start(false, path, (char*)arr.getData(), bytes, options);
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "Bits.h"
+#include "Container.h"
+#include "DynamicArray.h"
+
+/**
+* \brief Dynamic array of bits
+*
+* Stores 64 flags per word instead of one byte per flag.
+* The counting, searching and logical operations work on whole words.
+* The unused bits of the last word are always zero.
+*/
+class BitArray
+{
+private:
+	static constexpr float RESIZE_FACTOR = 1.6f;
+	static constexpr size_t WORD_BITS = 64;
+
+public:
+
+	//! Value returned by the search methods when no bit is found
+	static constexpr size_t npos = (size_t)-1;
+
+	//! Proxy reference to a single bit
+	class Reference
+	{
+	public:
+		operator bool() const;
+		Reference& operator=(bool value);
+		Reference& operator=(const Reference& other);
+		//! Inverts the bit
+		void flip();
+
+	private:
+		friend class BitArray;
+
+		Reference(uint64_t& word, uint64_t mask);
+
+		uint64_t& word;
+		uint64_t mask;
+	};
+
+	//! Default constructor
+	BitArray();
+	//! Constructs an array with the given number of bits with the given value
+	BitArray(size_t size, bool value = false);
+	//! Copy constructor
+	BitArray(const BitArray& other);
+	//! Constructs the object by the elements of a given initializer list
+	BitArray(const std::initializer_list<bool>& lst);
+
+	//! Operator =
+	BitArray& operator=(const BitArray& other);
+
+	/**
+	* \brief Access a bit at given position
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	bool operator[](size_t position) const;
+
+	/**
+	* \brief Access a bit at given position
+	*
+	* Returns a proxy which can be assigned to change the bit.
+	* If the position is invalid, the behaviour is undefined
+	*/
+	Reference operator[](size_t position);
+
+	/**
+	* \brief Access a bit at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	bool at(size_t position) const;
+
+	/**
+	* \brief Access a bit at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	Reference at(size_t position);
+
+	//! Add a bit on the back of the array
+	void push_back(bool value);
+
+	/**
+	* \brief Remove a bit
+	*
+	* Removes the bit at the last position.
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_back();
+
+	/**
+	* \brief Resize the array
+	*
+	* Changes the size of the array to the given one. The new bits are given the value of the second argument.
+	*/
+	void resize(size_t newSize, bool value = false);
+
+	//! Reserve space for at least the given number of bits
+	void reserve(size_t newCapacity);
+
+	//! Number of set bits
+	size_t count() const;
+
+	//! Position of the first set bit, npos if there is none
+	size_t find_first() const;
+
+	//! Position of the first set bit after the given position, npos if there is none
+	size_t find_next(size_t position) const;
+
+	//! Positions of all set bits in increasing order
+	DynamicArray<size_t> toIndices() const;
+
+	/**
+	* \brief Logical operations
+	*
+	* Combine the bits with the bits at the same positions of other, one word at a time.
+	* If the sizes of the arrays differ, throws an invalid_argument exception
+	*/
+	BitArray& operator&=(const BitArray& other);
+	BitArray& operator|=(const BitArray& other);
+	BitArray& operator^=(const BitArray& other);
+
+	//! Inverts all bits
+	void flip();
+
+	//! Returns a copy with all bits inverted
+	BitArray operator~() const;
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size in bits
+	size_t getSize() const;
+	//! Return capacity in bits
+	size_t getCapacity() const;
+
+private:
+
+	//! Number of words needed for the given number of bits
+	static size_t wordCount(size_t bits);
+
+	//! Zeroes the bits of the last word which are after the last position
+	void clearTail();
+	//! Throws if the sizes of the arrays differ
+	void checkSize(const BitArray& other) const;
+	//! Copies the data of other object
+	void copy(const BitArray& other);
+
+
+	// Class members:
+
+	Container<uint64_t> words;
+	size_t size; //!< Number of bits stored in the array
+};
+
+inline BitArray operator&(BitArray left, const BitArray& right) { return left &= right; }
+inline BitArray operator|(BitArray left, const BitArray& right) { return left |= right; }
+inline BitArray operator^(BitArray left, const BitArray& right) { return left ^= right; }
+
+#include "BitArray.ipp"
@@ -0,0 +1,277 @@
+#include "BitArray.h"
+
+inline BitArray::Reference::Reference(uint64_t& word, uint64_t mask) : word(word), mask(mask)
+{
+}
+
+inline BitArray::Reference::operator bool() const
+{
+	return (word & mask) != 0;
+}
+
+inline BitArray::Reference& BitArray::Reference::operator=(bool value)
+{
+	if (value)
+		word |= mask;
+	else
+		word &= ~mask;
+
+	return *this;
+}
+
+inline BitArray::Reference& BitArray::Reference::operator=(const Reference& other)
+{
+	return *this = (bool)other;
+}
+
+inline void BitArray::Reference::flip()
+{
+	word ^= mask;
+}
+
+inline BitArray::BitArray() : words(), size(0)
+{
+}
+
+inline BitArray::BitArray(size_t size, bool value) : BitArray()
+{
+	resize(size, value);
+}
+
+inline BitArray::BitArray(const BitArray& other) : BitArray()
+{
+	copy(other);
+}
+
+inline BitArray::BitArray(const std::initializer_list<bool>& lst) : BitArray()
+{
+	reserve(lst.size());
+	for (bool value : lst)
+		push_back(value);
+}
+
+inline BitArray& BitArray::operator=(const BitArray& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+inline bool BitArray::operator[](size_t position) const
+{
+	return (words[position / WORD_BITS] >> (position % WORD_BITS)) & 1;
+}
+
+inline BitArray::Reference BitArray::operator[](size_t position)
+{
+	return Reference(words[position / WORD_BITS], (uint64_t)1 << (position % WORD_BITS));
+}
+
+inline bool BitArray::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return (*this)[position];
+}
+
+inline BitArray::Reference BitArray::at(size_t position)
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return (*this)[position];
+}
+
+inline void BitArray::push_back(bool value)
+{
+	if (size == getCapacity()) {
+
+		size_t newCapacity = (size_t)(words.getCap() * RESIZE_FACTOR);
+		if (newCapacity < words.getInitCap())
+			newCapacity = words.getInitCap();
+
+		words.reserve(wordCount(size), newCapacity);
+	}
+
+	// A new word has to be cleared, the bits after the last position of the others are already zero
+	if (size % WORD_BITS == 0)
+		words[size / WORD_BITS] = 0;
+
+	if (value)
+		words[size / WORD_BITS] |= (uint64_t)1 << (size % WORD_BITS);
+	++size;
+}
+
+inline void BitArray::pop_back()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	--size;
+	clearTail();
+}
+
+inline void BitArray::resize(size_t newSize, bool value)
+{
+	if (newSize <= size) {
+		size = newSize;
+		clearTail();
+		return;
+	}
+
+	reserve(newSize);
+
+	size_t oldWords = wordCount(size);
+	uint64_t fill = value ? ~(uint64_t)0 : 0;
+
+	// Fill the rest of the current last word, then whole words
+	if (value && size % WORD_BITS != 0)
+		words[size / WORD_BITS] |= fill << (size % WORD_BITS);
+	for (size_t i = oldWords; i < wordCount(newSize); ++i)
+		words[i] = fill;
+
+	size = newSize;
+	clearTail();
+}
+
+inline void BitArray::reserve(size_t newCapacity)
+{
+	words.reserve(wordCount(size), wordCount(newCapacity));
+}
+
+inline size_t BitArray::count() const
+{
+	size_t result = 0;
+	for (size_t i = 0; i < wordCount(size); ++i)
+		result += popCount(words[i]);
+
+	return result;
+}
+
+inline size_t BitArray::find_first() const
+{
+	for (size_t i = 0; i < wordCount(size); ++i) {
+		if (words[i] != 0)
+			return i * WORD_BITS + countTrailingZeros(words[i]);
+	}
+
+	return npos;
+}
+
+inline size_t BitArray::find_next(size_t position) const
+{
+	++position;
+	if (position >= size)
+		return npos;
+
+	// The bits before the position in its word are masked out
+	size_t index = position / WORD_BITS;
+	uint64_t word = words[index] & (~(uint64_t)0 << (position % WORD_BITS));
+
+	while (word == 0) {
+		if (++index == wordCount(size))
+			return npos;
+		word = words[index];
+	}
+
+	return index * WORD_BITS + countTrailingZeros(word);
+}
+
+inline DynamicArray<size_t> BitArray::toIndices() const
+{
+	DynamicArray<size_t> result(count());
+
+	for (size_t i = 0; i < wordCount(size); ++i) {
+		// Clear the lowest set bit until the word is empty
+		for (uint64_t word = words[i]; word != 0; word &= word - 1)
+			result.push_back(i * WORD_BITS + countTrailingZeros(word));
+	}
+
+	return result;
+}
+
+inline BitArray& BitArray::operator&=(const BitArray& other)
+{
+	checkSize(other);
+	for (size_t i = 0; i < wordCount(size); ++i)
+		words[i] &= other.words[i];
+
+	return *this;
+}
+
+inline BitArray& BitArray::operator|=(const BitArray& other)
+{
+	checkSize(other);
+	for (size_t i = 0; i < wordCount(size); ++i)
+		words[i] |= other.words[i];
+
+	return *this;
+}
+
+inline BitArray& BitArray::operator^=(const BitArray& other)
+{
+	checkSize(other);
+	for (size_t i = 0; i < wordCount(size); ++i)
+		words[i] ^= other.words[i];
+
+	return *this;
+}
+
+inline void BitArray::flip()
+{
+	for (size_t i = 0; i < wordCount(size); ++i)
+		words[i] = ~words[i];
+
+	clearTail();
+}
+
+inline BitArray BitArray::operator~() const
+{
+	BitArray result(*this);
+	result.flip();
+	return result;
+}
+
+inline bool BitArray::empty() const
+{
+	return size == 0;
+}
+
+inline size_t BitArray::getSize() const
+{
+	return size;
+}
+
+inline size_t BitArray::getCapacity() const
+{
+	return words.getCap() * WORD_BITS;
+}
+
+inline size_t BitArray::wordCount(size_t bits)
+{
+	return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+inline void BitArray::clearTail()
+{
+	if (size % WORD_BITS != 0)
+		words[size / WORD_BITS] &= ((uint64_t)1 << (size % WORD_BITS)) - 1;
+}
+
+inline void BitArray::checkSize(const BitArray& other) const
+{
+	if (size != other.size)
+		throw std::invalid_argument("Arrays have different sizes\n");
+}
+
+inline void BitArray::copy(const BitArray& other)
+{
+	size = 0;
+	reserve(other.size);
+	for (size_t i = 0; i < wordCount(other.size); ++i)
+		words[i] = other.words[i];
+
+	size = other.size;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 32-bit MSVC targets have no 64-bit bit scan and population count intrinsics
+#if defined(_MSC_VER) && !defined(_M_X64) && !defined(_M_ARM64)
+#define BITS_MSVC_32
+#endif
+
+//! Number of set bits in a word
+inline unsigned popCount(uint64_t word)
+{
+#if defined(BITS_MSVC_32)
+	return (unsigned)(__popcnt((unsigned)word) + __popcnt((unsigned)(word >> 32)));
+#elif defined(_MSC_VER)
+	return (unsigned)__popcnt64(word);
+#else
+	return (unsigned)__builtin_popcountll(word);
+#endif
+}
+
+//! Index of the lowest set bit. The word must not be zero
+inline unsigned countTrailingZeros(uint64_t word)
+{
+#if defined(BITS_MSVC_32)
+	unsigned long index;
+	if (_BitScanForward(&index, (unsigned long)word))
+		return (unsigned)index;
+	_BitScanForward(&index, (unsigned long)(word >> 32));
+	return (unsigned)index + 32;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (unsigned)index;
+#else
+	return (unsigned)__builtin_ctzll(word);
+#endif
+}
+
+//! Index of the highest set bit. The word must not be zero
+inline unsigned highestBit(uint64_t word)
+{
+#if defined(BITS_MSVC_32)
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long)(word >> 32)))
+		return (unsigned)index + 32;
+	_BitScanReverse(&index, (unsigned long)word);
+	return (unsigned)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, word);
+	return (unsigned)index;
+#else
+	return 63 - (unsigned)__builtin_clzll(word);
+#endif
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "Bits.h"
+#include "DynamicArray.h"
+
+/**
+* \brief Append-only array of compressed unsigned integers
+*
+* The values are grouped in blocks of BLOCK_SIZE. Every full block is stored with frame of reference
+* compression: the smallest value is kept as the block base and the differences to it are bit-packed
+* with the smallest width that fits them. For sorted input the differences between neighbours are packed instead.
+* The block headers form a skip index, so the block of any position is found in O(1).
+* The last, incomplete block is kept uncompressed until it fills up.
+*/
+class CompressedIntArray
+{
+public:
+
+	static constexpr size_t BLOCK_SIZE = 128;
+
+	/**
+	* \brief Constructs an empty array
+	*
+	* If sorted is true, the values must be added in non-decreasing order and the blocks are delta encoded.
+	*/
+	CompressedIntArray(bool sorted = false);
+
+	/**
+	* \brief Add a value
+	*
+	* Adds a value on the back of the array. Every BLOCK_SIZE values the block is compressed.
+	* If the array is sorted and the value is less than the last one, throws an invalid_argument exception
+	*/
+	void push_back(uint64_t value);
+
+	/**
+	* \brief Read a value
+	*
+	* Unpacks a single value of a frame of reference block. In a sorted array the block is decoded up to the position.
+	* If the position is invalid, the behaviour is undefined
+	*/
+	uint64_t get(size_t position) const;
+
+	/**
+	* \brief Read a value
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	uint64_t at(size_t position) const;
+
+	/**
+	* \brief Decode a whole block
+	*
+	* Writes the values of the block with the given index to out, which must have room for BLOCK_SIZE values.
+	* The unpack loop has a fixed trip count and a per-block width, so the compiler can vectorize it.
+	* \return The number of values written, less than BLOCK_SIZE only for the last block
+	*/
+	size_t decodeBlock(size_t block, uint64_t* out) const;
+
+	//! Appends all values to out, block by block
+	void decode(DynamicArray<uint64_t>& out) const;
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+	//! Return the number of blocks, including the incomplete one
+	size_t getBlockCount() const;
+	//! Return the number of bytes used by the compressed blocks, their headers and the incomplete block
+	size_t getMemoryUsage() const;
+	//! Check if the array is delta encoded
+	bool isSorted() const;
+
+private:
+
+	struct BlockHeader {
+		uint64_t base;  //!< The smallest value in frame of reference mode, the first value in delta mode
+		size_t offset;  //!< Index of the first word of the block in words
+		unsigned width; //!< Number of bits per packed value
+	};
+
+	//! Compresses the values in tail as a new block
+	void compressTail();
+	//! Unpacks the packed values of a block without adding the base
+	void unpack(const BlockHeader& header, uint64_t* out) const;
+	//! Unpacks a single packed value of a block
+	uint64_t unpackOne(const BlockHeader& header, size_t index) const;
+
+
+	// Class members:
+
+	DynamicArray<BlockHeader> headers; //!< Skip index with one header per compressed block
+	DynamicArray<uint64_t> words;      //!< Packed values of all compressed blocks
+	uint64_t tail[BLOCK_SIZE];         //!< Values of the incomplete block
+	size_t tailSize;
+	size_t size;                       //!< Number of values stored in the array
+	uint64_t last;                     //!< The last value added
+	bool sorted;
+};
+
+#include "CompressedIntArray.ipp"
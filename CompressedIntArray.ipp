@@ -0,0 +1,191 @@
+#include "CompressedIntArray.h"
+
+inline CompressedIntArray::CompressedIntArray(bool sorted) : headers(), words(), tailSize(0), size(0), last(0), sorted(sorted)
+{
+}
+
+inline void CompressedIntArray::push_back(uint64_t value)
+{
+	if (sorted && size > 0 && value < last)
+		throw std::invalid_argument("Values of a sorted array must not decrease\n");
+
+	tail[tailSize] = value;
+	last = value;
+	++tailSize;
+	++size;
+
+	if (tailSize == BLOCK_SIZE)
+		compressTail();
+}
+
+inline uint64_t CompressedIntArray::get(size_t position) const
+{
+	size_t block = position / BLOCK_SIZE;
+	size_t index = position % BLOCK_SIZE;
+
+	if (block == headers.getSize())
+		return tail[index];
+
+	const BlockHeader& header = headers[block];
+	if (!sorted)
+		return header.base + unpackOne(header, index);
+
+	uint64_t value = header.base;
+	for (size_t i = 1; i <= index; ++i)
+		value += unpackOne(header, i);
+
+	return value;
+}
+
+inline uint64_t CompressedIntArray::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return get(position);
+}
+
+inline size_t CompressedIntArray::decodeBlock(size_t block, uint64_t* out) const
+{
+	if (block == headers.getSize()) {
+		for (size_t i = 0; i < tailSize; ++i)
+			out[i] = tail[i];
+		return tailSize;
+	}
+
+	const BlockHeader& header = headers[block];
+	unpack(header, out);
+
+	if (sorted) {
+		out[0] = header.base;
+		for (size_t i = 1; i < BLOCK_SIZE; ++i)
+			out[i] += out[i - 1];
+	}
+	else {
+		for (size_t i = 0; i < BLOCK_SIZE; ++i)
+			out[i] += header.base;
+	}
+
+	return BLOCK_SIZE;
+}
+
+inline void CompressedIntArray::decode(DynamicArray<uint64_t>& out) const
+{
+	uint64_t buffer[BLOCK_SIZE];
+	out.reserve(out.getSize() + size);
+
+	for (size_t block = 0; block < getBlockCount(); ++block) {
+		size_t count = decodeBlock(block, buffer);
+		for (size_t i = 0; i < count; ++i)
+			out.push_back(buffer[i]);
+	}
+}
+
+inline bool CompressedIntArray::empty() const
+{
+	return size == 0;
+}
+
+inline size_t CompressedIntArray::getSize() const
+{
+	return size;
+}
+
+inline size_t CompressedIntArray::getBlockCount() const
+{
+	return headers.getSize() + (tailSize > 0 ? 1 : 0);
+}
+
+inline size_t CompressedIntArray::getMemoryUsage() const
+{
+	return headers.getSize() * sizeof(BlockHeader) + words.getSize() * sizeof(uint64_t) + sizeof(tail);
+}
+
+inline bool CompressedIntArray::isSorted() const
+{
+	return sorted;
+}
+
+inline void CompressedIntArray::compressTail()
+{
+	uint64_t packed[BLOCK_SIZE];
+	BlockHeader header;
+	uint64_t largest = 0;
+
+	if (sorted) {
+		header.base = tail[0];
+		packed[0] = 0;
+		for (size_t i = 1; i < BLOCK_SIZE; ++i)
+			packed[i] = tail[i] - tail[i - 1];
+	}
+	else {
+		header.base = tail[0];
+		for (size_t i = 1; i < BLOCK_SIZE; ++i)
+			header.base = tail[i] < header.base ? tail[i] : header.base;
+		for (size_t i = 0; i < BLOCK_SIZE; ++i)
+			packed[i] = tail[i] - header.base;
+	}
+
+	for (size_t i = 0; i < BLOCK_SIZE; ++i)
+		largest |= packed[i];
+
+	header.width = largest == 0 ? 0 : highestBit(largest) + 1;
+	header.offset = words.getSize();
+
+	// BLOCK_SIZE values of width bits take exactly BLOCK_SIZE * width / 64 words, so blocks never share a word
+	size_t wordsPerBlock = BLOCK_SIZE * header.width / 64;
+	for (size_t i = 0; i < wordsPerBlock; ++i)
+		words.push_back(0);
+
+	for (size_t i = 0; i < BLOCK_SIZE && header.width > 0; ++i) {
+		size_t bit = i * header.width;
+		size_t index = header.offset + bit / 64;
+		unsigned shift = bit % 64;
+
+		words[index] |= packed[i] << shift;
+		if (shift + header.width > 64)
+			words[index + 1] |= packed[i] >> (64 - shift);
+	}
+
+	headers.push_back(header);
+	tailSize = 0;
+}
+
+inline void CompressedIntArray::unpack(const BlockHeader& header, uint64_t* out) const
+{
+	if (header.width == 0) {
+		for (size_t i = 0; i < BLOCK_SIZE; ++i)
+			out[i] = 0;
+		return;
+	}
+
+	const uint64_t* block = &words[header.offset];
+	const unsigned width = header.width;
+	const uint64_t mask = width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+
+	for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+		size_t bit = i * width;
+		unsigned shift = bit % 64;
+
+		uint64_t low = block[bit / 64] >> shift;
+		uint64_t high = shift + width > 64 ? block[bit / 64 + 1] << (64 - shift) : 0;
+		out[i] = (low | high) & mask;
+	}
+}
+
+inline uint64_t CompressedIntArray::unpackOne(const BlockHeader& header, size_t index) const
+{
+	if (header.width == 0)
+		return 0;
+
+	size_t bit = index * header.width;
+	size_t word = header.offset + bit / 64;
+	unsigned shift = bit % 64;
+	const uint64_t mask = header.width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << header.width) - 1;
+
+	uint64_t value = words[word] >> shift;
+	if (shift + header.width > 64)
+		value |= words[word + 1] << (64 - shift);
+
+	return value & mask;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <type_traits>
+
+/*
+* Since C++20 memory may be allocated during constant evaluation, as long as it is freed before
+* the evaluation ends. DYNAMIC_ARRAY_CONSTEXPR marks the functions which take part in it, so
+* containers can be built at compile time. It expands to nothing in earlier standards.
+*/
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L && defined(__cpp_lib_is_constant_evaluated)
+#define DYNAMIC_ARRAY_CONSTEXPR constexpr
+#define DYNAMIC_ARRAY_HAS_CONSTEXPR
+#else
+#define DYNAMIC_ARRAY_CONSTEXPR
+#endif
+
+//! True during constant evaluation, where only plain new[] and element loops may be used
+constexpr bool isConstantEvaluated()
+{
+#ifdef DYNAMIC_ARRAY_HAS_CONSTEXPR
+	return std::is_constant_evaluated();
+#else
+	return false;
+#endif
+}
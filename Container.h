@@ -1,71 +1,284 @@
 #pragma once
+#include <cstddef>
 #include <exception>
+#include <new>
+#include <type_traits>
+#include "Constexpr.h"
+#include "PageAllocator.h"
+#include "Parallel.h"
+#include "StreamingStore.h"
 
-template <class T>
+template <class T, size_t Alignment = alignof(T)>
 class Container {
 
 private:
+	static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+	static_assert(Alignment >= alignof(T), "Alignment must be at least alignof(T)");
+	static_assert(Alignment <= MAX_ALIGNMENT, "Alignment must not exceed the page size");
+
 	static constexpr size_t INITIAL_CAPACITY = 4;
+	//! Small buffers which new[] cannot align are allocated with allocateAligned(). Besides alignments
+	//! above alignof(max_align_t), new[] of a type with a destructor puts a cookie before the elements
+	static constexpr bool OVER_ALIGNED = Alignment > alignof(T) || Alignment > alignof(std::max_align_t);
 
 public:
 
-	Container() : data(nullptr), capacity(0) {}
+	DYNAMIC_ARRAY_CONSTEXPR Container() : data(nullptr), capacity(0), paged(false), placement(Placement::Local), threads(1), hugePages(false) {}
 
-	Container(size_t size) {
+	DYNAMIC_ARRAY_CONSTEXPR Container(size_t size) : Container() {
 		capacity = size < INITIAL_CAPACITY ? INITIAL_CAPACITY : size;
-		data = new T[capacity];
+		data = allocate(capacity);
+		paged = usesPages(capacity);
 	}
 
-	Container(const Container& other, size_t size) : Container(size) {
+	DYNAMIC_ARRAY_CONSTEXPR Container(const Container& other, size_t size)
+		: data(nullptr), capacity(0), paged(false), placement(other.placement), threads(other.threads), hugePages(other.hugePages) {
+		capacity = size < INITIAL_CAPACITY ? INITIAL_CAPACITY : size;
+		data = allocate(capacity);
+		paged = usesPages(capacity);
 
-		for (int i = 0; i < size; ++i)
-			data[i] = other[i];
+		copyRange(data, other.data, size);
 	}
 
-	~Container() {
+	DYNAMIC_ARRAY_CONSTEXPR ~Container() {
 		clear();
 	}
 
 
-	inline const T& operator[](size_t index) const { return data[index]; }
-	inline T& operator[](size_t index) { return const_cast<T&>(const_cast<const Container&>(*this)[index]); }
+	DYNAMIC_ARRAY_CONSTEXPR inline const T& operator[](size_t index) const { return data[index]; }
+	DYNAMIC_ARRAY_CONSTEXPR inline T& operator[](size_t index) { return const_cast<T&>(const_cast<const Container&>(*this)[index]); }
+
+	DYNAMIC_ARRAY_CONSTEXPR inline const T* getData() const { return data; }
+	DYNAMIC_ARRAY_CONSTEXPR inline T* getData() { return data; }
+
+	DYNAMIC_ARRAY_CONSTEXPR inline size_t getCap() const { return capacity; }
+	DYNAMIC_ARRAY_CONSTEXPR inline size_t getInitCap() const { return INITIAL_CAPACITY; }
 
-	inline size_t getCap() const { return capacity; }
-	inline size_t getInitCap() const { return INITIAL_CAPACITY; }
+	inline Placement getPlacement() const { return placement; }
+	inline bool getHugePages() const { return hugePages; }
+	inline unsigned getThreads() const { return threads; }
+
+	//! Sets the placement of the buffers allocated from now on. The placement stays with the object on swap()
+	inline void setPlacement(Placement newPlacement, unsigned newThreads) {
+		placement = newPlacement;
+		threads = newThreads == 0 ? hardwareThreads() : newThreads;
+	}
+
+	//! Sets if large buffers allocated from now on are backed by huge pages. The setting stays with the object on swap()
+	inline void setHugePages(bool enabled) {
+		hugePages = enabled;
+	}
 
-	inline void swap(Container& other) {
+	/**
+	* \brief Calls f(begin, end) on ranges of [0, count), which assigns the elements
+	*
+	* Large ranges are processed in parallel unless the placement is Local. Worker threads cannot
+	* pass exceptions on, so elements whose assignment may throw are always processed here
+	*/
+	template <class F>
+	inline void forRanges(size_t count, F f) const {
+		if (placement == Placement::Local || !std::is_nothrow_copy_assignable<T>::value || !isLargeAllocation(count * sizeof(T)))
+			f((size_t)0, count);
+		else
+			parallelFor(count, threads, f);
+	}
+
+	//! Copies count elements. Large ranges are written with streaming stores, so they do not evict the cache
+	DYNAMIC_ARRAY_CONSTEXPR inline void copyRange(T* target, const T* source, size_t count) const {
+		if (isConstantEvaluated()) {
+			for (size_t i = 0; i < count; ++i)
+				target[i] = source[i];
+			return;
+		}
+
+		bool streaming = isStreamingRange(count * sizeof(T));
+		forRanges(count, [=](size_t begin, size_t end) {
+			copyElements(target + begin, source + begin, end - begin, streaming);
+		});
+	}
+
+	//! Sets the elements in [begin, end) to value. Large ranges are written with streaming stores
+	DYNAMIC_ARRAY_CONSTEXPR inline void fillRange(size_t begin, size_t end, const T& value) {
+		if (isConstantEvaluated()) {
+			for (size_t i = begin; i < end; ++i)
+				data[i] = value;
+			return;
+		}
+
+		T* target = data + begin;
+		bool streaming = isStreamingRange((end - begin) * sizeof(T));
+		forRanges(end - begin, [=, &value](size_t from, size_t to) {
+			fillElements(target + from, to - from, value, streaming);
+		});
+	}
+
+	DYNAMIC_ARRAY_CONSTEXPR inline void swap(Container& other) {
 		std::swap(data, other.data);
-		capacity = other.capacity;
+		std::swap(capacity, other.capacity);
+		std::swap(paged, other.paged);
 	}
 	
-	inline void reserve(size_t curSize, size_t wantedSize) {
+	DYNAMIC_ARRAY_CONSTEXPR inline void reserve(size_t curSize, size_t wantedSize) {
 		if (wantedSize > capacity) {
 			if (wantedSize < INITIAL_CAPACITY)
 				wantedSize = INITIAL_CAPACITY;
 			T* temp = nullptr;
 			try {
-				temp = new T[wantedSize];
-				for (int i = 0; i < curSize; ++i)
-					temp[i] = data[i];
+				temp = allocate(wantedSize);
+				copyRange(temp, data, curSize);
 			}
 			catch (std::exception& e) {
 				throw e;
 			}
 
-			capacity = wantedSize;
 			std::swap(temp, data);
-			delete[] temp;
+			release(temp, capacity, paged);
+			capacity = wantedSize;
+			paged = usesPages(capacity);
 		}
 	}
 
-	inline void clear() {
+	//! Moves the first curSize elements to a smaller buffer of wantedSize elements, if that takes less memory than the current one
+	DYNAMIC_ARRAY_CONSTEXPR inline void shrink(size_t curSize, size_t wantedSize) {
+		if (wantedSize < curSize)
+			wantedSize = curSize;
+		if (wantedSize < INITIAL_CAPACITY)
+			wantedSize = INITIAL_CAPACITY;
+		if (wantedSize >= capacity)
+			return;
+		// Fewer elements may still need as many whole huge pages as the current buffer
+		if (paged && usesPages(wantedSize) && roundToHugePages(wantedSize * sizeof(T)) >= roundToHugePages(capacity * sizeof(T)))
+			return;
+
+		T* temp = allocate(wantedSize);
+		copyRange(temp, data, curSize);
+
+		std::swap(temp, data);
+		release(temp, capacity, paged);
+		capacity = wantedSize;
+		paged = usesPages(capacity);
+	}
+
+	DYNAMIC_ARRAY_CONSTEXPR inline void clear() {
 		if (data)
-			delete[] data;
+			release(data, capacity, paged);
+		data = nullptr;
 		capacity = 0;
+		paged = false;
 	}
 
 private:
 
+	//! Check if a buffer of count elements is allocated by allocatePages(). Placements other than Local need whole pages
+	DYNAMIC_ARRAY_CONSTEXPR bool usesPages(size_t count) const {
+		if (isConstantEvaluated())
+			return false;
+
+		return (hugePages || placement != Placement::Local) && isLargeAllocation(count * sizeof(T));
+	}
+
+	//! Allocates the given number of elements
+	DYNAMIC_ARRAY_CONSTEXPR T* allocate(size_t count) const {
+#ifdef DYNAMIC_ARRAY_HAS_CONSTEXPR
+		if (isConstantEvaluated())
+			return new T[count];
+#endif
+		if (!usesPages(count))
+			return allocateSmall(count, std::integral_constant<bool, OVER_ALIGNED>());
+
+		// Large buffers take whole huge pages. The rest of the last page stays unused, so the
+		// capacity is exactly the requested one, which users like RingArray rely on
+		size_t bytes = roundToHugePages(count * sizeof(T));
+		T* memory = (T*)allocatePages(bytes, hugePages);
+		placePages(memory, bytes, placement);
+
+		if (placement == Placement::Partitioned && std::is_nothrow_default_constructible<T>::value) {
+			// Each thread writes its range first, so its pages are placed on the thread's node
+			parallelFor(count, threads, [memory](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+					new (memory + i) T;
+			});
+		}
+		else {
+			try {
+				construct(memory, count);
+			}
+			catch (...) {
+				releasePages(memory, bytes);
+				throw;
+			}
+		}
+		return memory;
+	}
+
+	//! Releases a buffer returned by allocate() for the given number of elements. paged is usesPages() at the allocation
+	DYNAMIC_ARRAY_CONSTEXPR static void release(T* memory, size_t count, bool paged) {
+#ifdef DYNAMIC_ARRAY_HAS_CONSTEXPR
+		if (isConstantEvaluated()) {
+			delete[] memory;
+			return;
+		}
+#endif
+		if (!paged) {
+			releaseSmall(memory, count, std::integral_constant<bool, OVER_ALIGNED>());
+			return;
+		}
+
+		destroy(memory, count);
+		releasePages(memory, roundToHugePages(count * sizeof(T)));
+	}
+
+	static T* allocateSmall(size_t count, std::false_type) {
+		return new T[count];
+	}
+
+	//! new[] ignores alignments above alignof(max_align_t) before C++17 and may offset the elements by a cookie
+	static T* allocateSmall(size_t count, std::true_type) {
+		T* memory = (T*)allocateAligned(count * sizeof(T), Alignment);
+		try {
+			construct(memory, count);
+		}
+		catch (...) {
+			releaseAligned(memory);
+			throw;
+		}
+		return memory;
+	}
+
+	static void releaseSmall(T* memory, size_t, std::false_type) {
+		delete[] memory;
+	}
+
+	static void releaseSmall(T* memory, size_t count, std::true_type) {
+		destroy(memory, count);
+		releaseAligned(memory);
+	}
+
+	//! Default-initializes the elements of a buffer which was not allocated with new[]. If one throws, the others are destroyed
+	static void construct(T* memory, size_t count) {
+		size_t i = 0;
+		try {
+			for (; i < count; ++i)
+				new (memory + i) T;
+		}
+		catch (...) {
+			destroy(memory, i);
+			throw;
+		}
+	}
+
+	//! Destroys the elements of a buffer which was not allocated with new[]
+	static void destroy(T* memory, size_t count) {
+		if (!std::is_trivially_destructible<T>::value) {
+			for (size_t i = 0; i < count; ++i)
+				memory[i].~T();
+		}
+	}
+
 	T* data;
 	size_t capacity;
+	bool paged;       //!< The buffer comes from allocatePages()
+	Placement placement;
+	unsigned threads; //!< Number of threads which fill spread buffers
+	bool hugePages;   //!< Large buffers are backed by huge pages
 };
\ No newline at end of file
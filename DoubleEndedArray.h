@@ -0,0 +1,153 @@
+#pragma once
+#include <initializer_list>
+#include <stdexcept>
+#include "Container.h"
+
+/**
+* \brief Dynamic array with free space on both ends
+*
+* The elements are stored contiguously in the middle of a Container buffer, with slack before and after them.
+* Adding or removing elements on either end is amortized O(1), while the storage stays contiguous
+* and operator[] is a single indexed load from the cached pointer to the first element.
+*/
+template <class T>
+class DoubleEndedArray
+{
+private:
+	static constexpr float RESIZE_FACTOR = 1.6f;
+
+public:
+
+	//! Default constructor
+	DoubleEndedArray();
+	//! Constructs the object by allocating memory. The free space is left on the back
+	DoubleEndedArray(size_t capacity);
+	//! Copy constructor
+	DoubleEndedArray(const DoubleEndedArray<T>& other);
+	//! Constructs the object by the elements of a given initializer list
+	DoubleEndedArray(const std::initializer_list<T>& lst);
+
+	//! Operator =
+	DoubleEndedArray& operator=(const DoubleEndedArray<T>& other);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const T& operator[](size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	T& operator[](size_t position);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	const T& at(size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	T& at(size_t position);
+
+	//! Access the first element. If the array is empty, the behaviour is undefined
+	const T& front() const;
+	//! Access the first element. If the array is empty, the behaviour is undefined
+	T& front();
+	//! Access the last element. If the array is empty, the behaviour is undefined
+	const T& back() const;
+	//! Access the last element. If the array is empty, the behaviour is undefined
+	T& back();
+
+	/**
+	* \brief Add an element on the back
+	*
+	* If there is no free space after the elements, they are either moved to the middle of the buffer
+	* (when at most half of it is used) or copied into a bigger buffer with the new space on the back.
+	*/
+	void push_back(const T& element);
+
+	/**
+	* \brief Add an element on the front
+	*
+	* If there is no free space before the elements, they are either moved to the middle of the buffer
+	* (when at most half of it is used) or copied into a bigger buffer with the new space on the front.
+	*/
+	void push_front(const T& element);
+
+	/**
+	* \brief Remove the last element
+	*
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_back();
+
+	/**
+	* \brief Remove the first element
+	*
+	* The freed slot becomes free space on the front.
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_front();
+
+	/**
+	* \brief Reserve extra space
+	*
+	* Changes the capacity of the array to the given one, only if it is greater than the current one.
+	* The free space on the front is preserved and the new space is added on the back.
+	*/
+	void reserve(size_t newCapacity);
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return pointer to the first element
+	const T* getData() const;
+	//! Return pointer to the first element
+	T* getData();
+
+	//! Return size
+	size_t getSize() const;
+	//! Return capacity
+	size_t getCapacity() const;
+	//! Return the number of free slots before the first element
+	size_t getFrontSlack() const;
+	//! Return the number of free slots after the last element
+	size_t getBackSlack() const;
+
+private:
+
+	//! Moves the elements so that the first one is at the given offset of a buffer with the given capacity
+	void relocate(size_t newCapacity, size_t newOffset);
+	//! Makes room for one element on the back
+	void growBack();
+	//! Makes room for one element on the front
+	void growFront();
+	//! Capacity used when the array has to grow
+	size_t nextCapacity() const;
+	//! Copies the data of other object
+	void copy(const DoubleEndedArray<T>& other);
+
+
+	// Class members:
+
+	Container<T> data;
+	T* first;      //!< Pointer to the first element inside data
+	size_t offset; //!< Index of the first element inside data
+	size_t size;   //!< Number of elements stored in the array
+};
+
+#include "DoubleEndedArray.ipp"
@@ -0,0 +1,251 @@
+#include "DoubleEndedArray.h"
+
+template<class T>
+inline DoubleEndedArray<T>::DoubleEndedArray() : data(), first(nullptr), offset(0), size(0)
+{
+}
+
+template<class T>
+inline DoubleEndedArray<T>::DoubleEndedArray(size_t capacity) : data(capacity), offset(0), size(0)
+{
+	first = data.getData();
+}
+
+template<class T>
+inline DoubleEndedArray<T>::DoubleEndedArray(const DoubleEndedArray<T>& other) : DoubleEndedArray()
+{
+	copy(other);
+}
+
+template<class T>
+inline DoubleEndedArray<T>::DoubleEndedArray(const std::initializer_list<T>& lst) : DoubleEndedArray(lst.size())
+{
+	for (const T& element : lst)
+		first[size++] = element;
+}
+
+template<class T>
+inline DoubleEndedArray<T>& DoubleEndedArray<T>::operator=(const DoubleEndedArray<T>& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+template<class T>
+inline const T& DoubleEndedArray<T>::operator[](size_t position) const
+{
+	return first[position];
+}
+
+template<class T>
+inline T& DoubleEndedArray<T>::operator[](size_t position)
+{
+	return const_cast<T&>(const_cast<const DoubleEndedArray&>(*this)[position]);
+}
+
+template<class T>
+inline const T& DoubleEndedArray<T>::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return first[position];
+}
+
+template<class T>
+inline T& DoubleEndedArray<T>::at(size_t position)
+{
+	return const_cast<T&>(const_cast<const DoubleEndedArray&>(*this).at(position));
+}
+
+template<class T>
+inline const T& DoubleEndedArray<T>::front() const
+{
+	return first[0];
+}
+
+template<class T>
+inline T& DoubleEndedArray<T>::front()
+{
+	return const_cast<T&>(const_cast<const DoubleEndedArray&>(*this).front());
+}
+
+template<class T>
+inline const T& DoubleEndedArray<T>::back() const
+{
+	return first[size - 1];
+}
+
+template<class T>
+inline T& DoubleEndedArray<T>::back()
+{
+	return const_cast<T&>(const_cast<const DoubleEndedArray&>(*this).back());
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::push_back(const T& element)
+{
+	if (offset + size == data.getCap())
+		growBack();
+
+	first[size] = element;
+	++size;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::push_front(const T& element)
+{
+	if (offset == 0)
+		growFront();
+
+	--offset;
+	--first;
+	first[0] = element;
+	++size;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::pop_back()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	--size;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::pop_front()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	++offset;
+	++first;
+	--size;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::reserve(size_t newCapacity)
+{
+	if (newCapacity > data.getCap())
+		relocate(newCapacity, offset);
+}
+
+template<class T>
+inline bool DoubleEndedArray<T>::empty() const
+{
+	return size == 0;
+}
+
+template<class T>
+inline const T* DoubleEndedArray<T>::getData() const
+{
+	return first;
+}
+
+template<class T>
+inline T* DoubleEndedArray<T>::getData()
+{
+	return first;
+}
+
+template<class T>
+inline size_t DoubleEndedArray<T>::getSize() const
+{
+	return size;
+}
+
+template<class T>
+inline size_t DoubleEndedArray<T>::getCapacity() const
+{
+	return data.getCap();
+}
+
+template<class T>
+inline size_t DoubleEndedArray<T>::getFrontSlack() const
+{
+	return offset;
+}
+
+template<class T>
+inline size_t DoubleEndedArray<T>::getBackSlack() const
+{
+	return data.getCap() - offset - size;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::relocate(size_t newCapacity, size_t newOffset)
+{
+	if (newCapacity == data.getCap()) {
+		// Moving inside the same buffer, the copy direction depends on the overlap
+		T* target = data.getData() + newOffset;
+		if (newOffset < offset) {
+			for (size_t i = 0; i < size; ++i)
+				target[i] = first[i];
+		}
+		else {
+			for (size_t i = size; i > 0; --i)
+				target[i - 1] = first[i - 1];
+		}
+	}
+	else {
+		Container<T> temp(newCapacity);
+		for (size_t i = 0; i < size; ++i)
+			temp[newOffset + i] = first[i];
+
+		data.swap(temp);
+	}
+
+	offset = newOffset;
+	first = data.getData() + offset;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::growBack()
+{
+	// Moving to the middle is enough if at most half of the buffer is used
+	if (size < data.getCap() / 2)
+		relocate(data.getCap(), (data.getCap() - size) / 2);
+	else
+		relocate(nextCapacity(), offset);
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::growFront()
+{
+	if (size < data.getCap() / 2) {
+		relocate(data.getCap(), (data.getCap() - size + 1) / 2);
+	}
+	else {
+		// The back slack is preserved and the new space goes on the front
+		size_t newCapacity = nextCapacity();
+		relocate(newCapacity, newCapacity - size - getBackSlack());
+	}
+}
+
+template<class T>
+inline size_t DoubleEndedArray<T>::nextCapacity() const
+{
+	size_t newCapacity = (size_t)(data.getCap() * RESIZE_FACTOR);
+	if (newCapacity < data.getInitCap())
+		newCapacity = data.getInitCap();
+
+	return newCapacity;
+}
+
+template<class T>
+inline void DoubleEndedArray<T>::copy(const DoubleEndedArray<T>& other)
+{
+	if (data.getCap() < other.size) {
+		Container<T> temp(other.size);
+		data.swap(temp);
+	}
+
+	offset = 0;
+	first = data.getData();
+	for (size_t i = 0; i < other.size; ++i)
+		first[i] = other.first[i];
+
+	size = other.size;
+}
@@ -1,9 +1,37 @@
 #pragma once
 #include <initializer_list>
 #include <stdexcept>
+#include "Constexpr.h"
 #include "Container.h"
+#include "Gather.h"
+#include "Span.h"
 
-template <class T>
+/**
+* \brief When pop_back() and resize() release memory
+*
+* Once the size drops below capacity * threshold, the buffer is replaced by one of size * target
+* elements. A target above 1 leaves room to grow again, and threshold * target below 1 makes the
+* next shrink wait until the size has dropped much further, so an array whose size moves around one
+* value does not reallocate over and over.
+*/
+struct ShrinkPolicy
+{
+	float threshold; //!< Shrink when the size drops below capacity * threshold. 0 never shrinks
+	float target;    //!< Capacity after shrinking, as a multiple of the size
+};
+
+//! Never release memory on pop_back() and resize(). The default
+static constexpr ShrinkPolicy SHRINK_NEVER = { 0.0f, 1.0f };
+//! Shrink to twice the size when the size drops below a quarter of the capacity
+static constexpr ShrinkPolicy SHRINK_QUARTER = { 0.25f, 2.0f };
+
+/**
+* \brief Growable array with contiguous storage
+*
+* The buffer start is aligned to Alignment bytes, which must be a power of two between alignof(T)
+* and the page size. Over-aligned element types get their own alignment by default.
+*/
+template <class T, size_t Alignment = alignof(T)>
 class DynamicArray
 {
 private:
@@ -12,16 +40,16 @@ private:
 public:
 
 	//! Default constructor
-	DynamicArray();
+	DYNAMIC_ARRAY_CONSTEXPR DynamicArray();
 	//! Constructs the object by allocating memory
-	DynamicArray(size_t newSize);
+	DYNAMIC_ARRAY_CONSTEXPR DynamicArray(size_t newSize);
 	//! Copy constructor
-	DynamicArray(const DynamicArray<T>& other);
+	DYNAMIC_ARRAY_CONSTEXPR DynamicArray(const DynamicArray& other);
 	//! Constructs the object by the elements of a given initializer list
-	DynamicArray(const std::initializer_list<T>& lst);
+	DYNAMIC_ARRAY_CONSTEXPR DynamicArray(const std::initializer_list<T>& lst);
 	
 	//! Operator =
-	DynamicArray& operator=(const DynamicArray<T>& other);
+	DYNAMIC_ARRAY_CONSTEXPR DynamicArray& operator=(const DynamicArray& other);
 
 	/**
 	* \brief Access an element at given position
@@ -29,7 +57,7 @@ public:
 	* By given position returns a const reference to the element at that position
 	* If the position is invalid, the behaviour is undefined
 	*/
-	const T& operator[](size_t position) const;
+	DYNAMIC_ARRAY_CONSTEXPR const T& operator[](size_t position) const;
 
 	/**
 	* \brief Access an element at given position
@@ -37,7 +65,7 @@ public:
 	* By given position returns a reference to the element at that position
 	* If the position is invalid, the behaviour is undefined
 	*/
-	T& operator[](size_t position);
+	DYNAMIC_ARRAY_CONSTEXPR T& operator[](size_t position);
 
 	/**
 	* \brief Access an element at given position
@@ -45,7 +73,7 @@ public:
 	* By given position returns a const reference to the element at that position
 	* If the position is invalid, throws an out_of_range exception
 	*/
-	const T& at(size_t position) const;
+	DYNAMIC_ARRAY_CONSTEXPR const T& at(size_t position) const;
 
 	/**
 	* \brief Access an element at given position
@@ -53,7 +81,7 @@ public:
 	* By given position returns a reference to the element at that position
 	* If the position is invalid, throws an out_of_range exception
 	*/
-	T& at(size_t position);
+	DYNAMIC_ARRAY_CONSTEXPR T& at(size_t position);
 
 	/**
 	* \brief Access the first element
@@ -61,7 +89,7 @@ public:
 	* Returns a const reference to the element at index 0
 	* If the array is empty, the behaviour is undefined
 	*/
-	const T& front() const;
+	DYNAMIC_ARRAY_CONSTEXPR const T& front() const;
 
 	/**
 	* \brief Access the first element
@@ -69,7 +97,7 @@ public:
 	* Returns a reference to the element at index 0
 	* If the array is empty, the behaviour is undefined
 	*/
-	T& front();
+	DYNAMIC_ARRAY_CONSTEXPR T& front();
 
 
 	/**
@@ -78,7 +106,7 @@ public:
 	* Returns a const reference to the element at index size - 1
 	* If the array is empty, the behaviour is undefined
 	*/
-	const T& back() const;
+	DYNAMIC_ARRAY_CONSTEXPR const T& back() const;
 
 	/**
 	* \brief Access the last element
@@ -86,7 +114,7 @@ public:
 	* Returns a reference to the element at index size - 1
 	* If the array is empty, the behaviour is undefined
 	*/
-	T& back();
+	DYNAMIC_ARRAY_CONSTEXPR T& back();
 
 	/**
 	* \brief Add an element
@@ -94,7 +122,7 @@ public:
 	* Adds an element on the back of the array.
 	* If the array is full then it's capacity is increased. Otherwise an element is just added at position size for O(1) time.
 	*/
-	void push_back(const T& element);
+	DYNAMIC_ARRAY_CONSTEXPR void push_back(const T& element);
 
 	/**
 	* \brief Remove an element
@@ -102,9 +130,10 @@ public:
 	* Removes the element at the last position.
 	* The element is not actually deleted. Only the size of the array is decreased.
 	* Using push_back() after pop_back() will lead to overwriting the element of the last position.
+	* The capacity is reduced as the shrink policy says.
 	* Trying to execute the method on empty array will throw an exception
 	*/
-	void pop_back();
+	DYNAMIC_ARRAY_CONSTEXPR void pop_back();
 
 	/**
 	* \brief Resize the array
@@ -114,9 +143,10 @@ public:
 	* If the current size is less than the wanted size, it is being increased.
 	* If the capacity is also less than than the wanted size, the capacity is also being increased.
 	* The value of the new elements is undefined.
-	* If the current size is more than the wanted size then the size is decreased but the elements are not deleted.
+	* If the current size is more than the wanted size then the size is decreased but the elements are not deleted,
+	* and the capacity is reduced as the shrink policy says.
 	*/
-	void resize(size_t newSize);
+	DYNAMIC_ARRAY_CONSTEXPR void resize(size_t newSize);
 
 	/**
 	* \brief Resize the array
@@ -126,26 +156,28 @@ public:
 	* If the current size is less than the wanted size, it is being increased.
 	* If the capacity is also less than than the wanted size, the capacity is also being increased.
 	* The new elements are given the value of the second argument of the method.
-	* If the current size is more than the wanted size then the size is decreased but the elements are not deleted.
+	* If the current size is more than the wanted size then the size is decreased but the elements are not deleted,
+	* and the capacity is reduced as the shrink policy says.
 	*/
-	void resize(size_t newSize, const T& value);
+	DYNAMIC_ARRAY_CONSTEXPR void resize(size_t newSize, const T& value);
 
 
 	/**
 	* \brief Reserve extra space
 	* 
 	* Changes the capacity of the array to the given one, only if it is greater than the current one.
-	* Otherwise it does nothing.
+	* Otherwise it does nothing. The capacity is exactly the given one also when a large buffer is
+	* rounded up to whole huge pages.
 	* The elements and the size of the array are not touched.
 	*/
-	void reserve(size_t newCapacity);
+	DYNAMIC_ARRAY_CONSTEXPR void reserve(size_t newCapacity);
 
 	/**
 	* \brief Reduce the capacity
 	* 
 	* If the capacity is more than the size of the array, the capacity is changed to the value of the size.
 	*/
-	void shrink_to_fit();
+	DYNAMIC_ARRAY_CONSTEXPR void shrink_to_fit();
 
 	/**
 	* \brief Check if the array is empty
@@ -153,30 +185,129 @@ public:
 	*  \return True if size = 0
 	*  \return False if size != 0
 	*/
-	bool empty() const;
+	DYNAMIC_ARRAY_CONSTEXPR bool empty() const;
+
+	/**
+	* \brief Prepare room for elements written in place
+	*
+	* Makes the capacity at least size + count and returns the count elements after the last one.
+	* Their values are unspecified until they are written. The size is not changed, so the elements
+	* become part of the array only after commitTail(). Lets read(), recv() and similar calls fill
+	* the array directly, without a temporary buffer.
+	*/
+	Span<T> prepareTail(size_t count);
+
+	/**
+	* \brief Append elements written in place
+	*
+	* Increases the size by count, taking the first count elements returned by prepareTail().
+	* If count is more than the free capacity, throws an out_of_range exception
+	*/
+	void commitTail(size_t count);
+
+	//! Return pointer to the first element
+	DYNAMIC_ARRAY_CONSTEXPR const T* getData() const;
+	//! Return pointer to the first element
+	DYNAMIC_ARRAY_CONSTEXPR T* getData();
 
 	//! Return size
-	size_t getSize() const;
+	DYNAMIC_ARRAY_CONSTEXPR size_t getSize() const;
 	//! Return capacity
-	size_t getCapacity() const;
+	DYNAMIC_ARRAY_CONSTEXPR size_t getCapacity() const;
 
 	//! Return the initial capacity value 
-	size_t getInitCap() const;
+	DYNAMIC_ARRAY_CONSTEXPR size_t getInitCap() const;
 	//! Return the resizing factor value
-	float getResizeFactor() const;
+	DYNAMIC_ARRAY_CONSTEXPR float getResizeFactor() const;
+
+	/**
+	* \brief Set the NUMA placement of large buffers
+	*
+	* Applies to the buffers allocated from now on, so it is usually called before reserve() or resize().
+	* With Interleaved and Partitioned placements large buffers are filled and copied by the given
+	* number of threads (0 means one per hardware thread). With Partitioned the pages of each of these
+	* ranges are placed on the node of the thread which fills it, so parallel scans which split the
+	* array the same way read local memory.
+	*/
+	void setPlacement(Placement placement, unsigned threads = 0);
+	//! Return the NUMA placement of large buffers
+	Placement getPlacement() const;
+
+	/**
+	* \brief Back large buffers by huge pages
+	*
+	* Applies to the buffers allocated from now on. Buffers of at least HUGE_PAGE_THRESHOLD bytes are
+	* then aligned to HUGE_PAGE_SIZE and rounded up to whole huge pages, which cuts TLB misses of
+	* random access into large arrays. The capacity is not affected. Off by default.
+	*/
+	void setHugePages(bool enabled);
+	//! Check if large buffers are backed by huge pages
+	bool getHugePages() const;
+
+	/**
+	* \brief Set when pop_back() and resize() release memory
+	*
+	* Takes effect on the next pop_back() or resize(). The policy stays with the object, copies start
+	* with SHRINK_NEVER. If threshold is not in [0, 1), or a shrinking policy has target not above 1
+	* or threshold * target not below 1, throws an invalid_argument exception
+	*/
+	void setShrinkPolicy(const ShrinkPolicy& policy);
+	//! Return the shrink policy
+	ShrinkPolicy getShrinkPolicy() const;
+
+	/**
+	* \brief Indexed load
+	*
+	* Resizes out to the number of indices and sets out[i] to the element at position indices[i].
+	* Elements are prefetched prefetchDistance indices ahead, so the cache misses overlap.
+	* If an index is invalid, the behaviour is undefined
+	*/
+	void gather(const DynamicArray<size_t>& indices, DynamicArray& out, size_t prefetchDistance = GATHER_PREFETCH_DISTANCE) const;
+
+	/**
+	* \brief Indexed store
+	*
+	* Sets the element at position indices[i] to values[i], in increasing order of i, so the last
+	* of repeated indices wins. Elements are prefetched prefetchDistance indices ahead.
+	* If the arrays have different sizes, throws an invalid_argument exception.
+	* If an index is invalid, the behaviour is undefined
+	*/
+	void scatter(const DynamicArray<size_t>& indices, const DynamicArray& values, size_t prefetchDistance = GATHER_PREFETCH_DISTANCE);
+
+	/**
+	* \brief Indexed load in batches of sorted indices
+	*
+	* Same result as gather(). The indices are sorted in batches and the elements are read in increasing
+	* order of position, so neighbouring indices share cache lines and pages. Pays off for large arrays
+	* with many indices.
+	*/
+	void gatherSorted(const DynamicArray<size_t>& indices, DynamicArray& out) const;
+
+	/**
+	* \brief Indexed store in batches of sorted indices
+	*
+	* Same result as scatter(). The indices are sorted in batches and the elements are written in
+	* increasing order of position.
+	*/
+	void scatterSorted(const DynamicArray<size_t>& indices, const DynamicArray& values);
 
 private:
 
 	//! Copies the data of other object
-	void copy(const DynamicArray<T>& other);
+	DYNAMIC_ARRAY_CONSTEXPR void copy(const DynamicArray& other);
+	//! Positions [begin, end) of the indices, sorted stably by index
+	static DynamicArray<size_t> sortedOrder(const DynamicArray<size_t>& indices, size_t begin, size_t end);
 	//! Free allocated memory and zeroes class members
-	void clear();
+	DYNAMIC_ARRAY_CONSTEXPR void clear();
+	//! Reduces the capacity if the shrink policy asks for it
+	DYNAMIC_ARRAY_CONSTEXPR void shrinkIfSparse();
 
 
 	// Class members:
 	
-	Container<T> data;
+	Container<T, Alignment> data;
 	size_t size; //!< Number of elements stored in the array
+	ShrinkPolicy shrinkPolicy;
 };
 
 #include "DynamicArray.ipp"
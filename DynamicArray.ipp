@@ -1,23 +1,24 @@
 #include "DynamicArray.h"
+#include <algorithm>
 
-template<class T>
-inline DynamicArray<T>::DynamicArray() : data(), size(0)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline DynamicArray<T, Alignment>::DynamicArray() : data(), size(0), shrinkPolicy(SHRINK_NEVER)
 {
 }
 
-template<class T>
-inline DynamicArray<T>::DynamicArray(size_t newSize) : data(newSize), size(0)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline DynamicArray<T, Alignment>::DynamicArray(size_t newSize) : data(newSize), size(0), shrinkPolicy(SHRINK_NEVER)
 {
 }
 
-template<class T>
-inline DynamicArray<T>::DynamicArray(const DynamicArray& other)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline DynamicArray<T, Alignment>::DynamicArray(const DynamicArray& other) : shrinkPolicy(SHRINK_NEVER)
 {
 	copy(other);
 }
 
-template<class T>
-inline DynamicArray<T>::DynamicArray(const std::initializer_list<T>& lst)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline DynamicArray<T, Alignment>::DynamicArray(const std::initializer_list<T>& lst) : shrinkPolicy(SHRINK_NEVER)
 {
 	size_t capacity = lst.size() > data.getInitCap() ? lst.size() : data.getInitCap();
 	
@@ -33,8 +34,8 @@ inline DynamicArray<T>::DynamicArray(const std::initializer_list<T>& lst)
 	size = lst.size();
 }
 
-template<class T>
-inline DynamicArray<T>& DynamicArray<T>::operator=(const DynamicArray<T>& other)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline DynamicArray<T, Alignment>& DynamicArray<T, Alignment>::operator=(const DynamicArray<T, Alignment>& other)
 {
 	if (this != &other) {
 		copy(other);
@@ -43,20 +44,20 @@ inline DynamicArray<T>& DynamicArray<T>::operator=(const DynamicArray<T>& other)
 	return *this;
 }
 
-template<class T>
-inline const T& DynamicArray<T>::operator[](size_t position) const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline const T& DynamicArray<T, Alignment>::operator[](size_t position) const
 {
 	return data[position];
 }
 
-template<class T>
-inline T& DynamicArray<T>::operator[](size_t position)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline T& DynamicArray<T, Alignment>::operator[](size_t position)
 {
 	return const_cast<T&>(const_cast<const DynamicArray&>(*this)[position]);
 }
 
-template<class T>
-inline const T& DynamicArray<T>::at(size_t position) const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline const T& DynamicArray<T, Alignment>::at(size_t position) const
 {
 	if (size <= position || position < 0)
 		throw std::out_of_range("Out of range\n");
@@ -64,38 +65,38 @@ inline const T& DynamicArray<T>::at(size_t position) const
 	return data[position];
 }
 
-template<class T>
-inline T& DynamicArray<T>::at(size_t position)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline T& DynamicArray<T, Alignment>::at(size_t position)
 {
 	return const_cast<T&>(const_cast<const DynamicArray&>(*this).at(position));
 }
 
-template<class T>
-inline const T& DynamicArray<T>::front() const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline const T& DynamicArray<T, Alignment>::front() const
 {
 	return data[0];
 }
 
-template<class T>
-inline T& DynamicArray<T>::front()
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline T& DynamicArray<T, Alignment>::front()
 {
 	return const_cast<T&>(const_cast<const DynamicArray&>(*this).front());
 }
 
-template<class T>
-inline const T& DynamicArray<T>::back() const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline const T& DynamicArray<T, Alignment>::back() const
 {
 	return data[size - 1];
 }
 
-template<class T>
-inline T& DynamicArray<T>::back()
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline T& DynamicArray<T, Alignment>::back()
 {
 	return const_cast<T&>(const_cast<const DynamicArray&>(*this).back());
 }
 
-template<class T>
-inline void DynamicArray<T>::push_back(const T& element)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::push_back(const T& element)
 {
 	if (size == data.getCap()) {
 
@@ -110,16 +111,18 @@ inline void DynamicArray<T>::push_back(const T& element)
 	++size;
 }
 
-template<class T>
-inline void DynamicArray<T>::pop_back()
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::pop_back()
 {
 	if (empty())
 		throw std::logic_error("Pop from empty array\n");
 	--size;
+
+	shrinkIfSparse();
 }
 
-template<class T>
-inline void DynamicArray<T>::resize(size_t newSize)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::resize(size_t newSize)
 {
 	if (newSize == size)
 		return;
@@ -129,28 +132,30 @@ inline void DynamicArray<T>::resize(size_t newSize)
 
 	// If newSize is less than the current capacity, it does nothing
 	data.reserve(oldSize, newSize);
+
+	if (newSize < oldSize)
+		shrinkIfSparse();
 }
 
-template<class T>
-inline void DynamicArray<T>::resize(size_t newSize, const T& value)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::resize(size_t newSize, const T& value)
 {
 	size_t oldSize = size;
 	resize(newSize);
 
 	if (oldSize < size) {
-		for (size_t i = oldSize; i < size; ++i)
-			data[i] = value;
+		data.fillRange(oldSize, size, value);
 	}
 }
 
-template<class T>
-inline void DynamicArray<T>::reserve(size_t newCapacity)
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::reserve(size_t newCapacity)
 {
 	data.reserve(size, newCapacity);
 }
 
-template<class T>
-inline void DynamicArray<T>::shrink_to_fit()
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::shrink_to_fit()
 {
 	if (size == data.getCap())
 		return;
@@ -160,42 +165,173 @@ inline void DynamicArray<T>::shrink_to_fit()
 		return;
 	}
 
-	Container<T> temp(data, size);
+	Container<T, Alignment> temp(data, size);
 	data.swap(temp);
 }
 
-template<class T>
-inline bool DynamicArray<T>::empty() const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline bool DynamicArray<T, Alignment>::empty() const
 {
 	return size == 0;
 }
 
-template<class T>
-inline size_t DynamicArray<T>::getSize() const
+template<class T, size_t Alignment>
+inline Span<T> DynamicArray<T, Alignment>::prepareTail(size_t count)
+{
+	if (data.getCap() - size < count) {
+		// Grow geometrically, so ingesting in small chunks stays amortized O(1) per element
+		size_t newCapacity = (size_t)(data.getCap() * RESIZE_FACTOR);
+		if (newCapacity < size + count)
+			newCapacity = size + count;
+
+		data.reserve(size, newCapacity);
+	}
+
+	return Span<T>(data.getData() + size, count);
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::commitTail(size_t count)
+{
+	if (data.getCap() - size < count)
+		throw std::out_of_range("Out of range\n");
+
+	size += count;
+}
+
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline const T* DynamicArray<T, Alignment>::getData() const
+{
+	return data.getData();
+}
+
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline T* DynamicArray<T, Alignment>::getData()
+{
+	return data.getData();
+}
+
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline size_t DynamicArray<T, Alignment>::getSize() const
 {
 	return size;
 }
 
-template<class T>
-inline size_t DynamicArray<T>::getCapacity() const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline size_t DynamicArray<T, Alignment>::getCapacity() const
 {
 	return data.getCap();
 }
 
-template<class T>
-inline size_t DynamicArray<T>::getInitCap() const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline size_t DynamicArray<T, Alignment>::getInitCap() const
 {
 	return data.getInitCap();
 }
 
-template<class T>
-inline float DynamicArray<T>::getResizeFactor() const
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline float DynamicArray<T, Alignment>::getResizeFactor() const
 {
 	return RESIZE_FACTOR;
 }
 
-template<class T>
-inline void DynamicArray<T>::copy(const DynamicArray<T>& other)
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::setPlacement(Placement placement, unsigned threads)
+{
+	data.setPlacement(placement, threads);
+}
+
+template<class T, size_t Alignment>
+inline Placement DynamicArray<T, Alignment>::getPlacement() const
+{
+	return data.getPlacement();
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::setHugePages(bool enabled)
+{
+	data.setHugePages(enabled);
+}
+
+template<class T, size_t Alignment>
+inline bool DynamicArray<T, Alignment>::getHugePages() const
+{
+	return data.getHugePages();
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::setShrinkPolicy(const ShrinkPolicy& policy)
+{
+	if (!(policy.threshold >= 0 && policy.threshold < 1))
+		throw std::invalid_argument("Shrink threshold must be in [0, 1)\n");
+	if (policy.threshold > 0 && !(policy.target > 1 && policy.threshold * policy.target < 1))
+		throw std::invalid_argument("Shrink target must be above 1 and below 1 / threshold\n");
+
+	shrinkPolicy = policy;
+}
+
+template<class T, size_t Alignment>
+inline ShrinkPolicy DynamicArray<T, Alignment>::getShrinkPolicy() const
+{
+	return shrinkPolicy;
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::gather(const DynamicArray<size_t>& indices, DynamicArray<T, Alignment>& out, size_t prefetchDistance) const
+{
+	out.resize(indices.getSize());
+	gatherElements(getData(), indices.getData(), indices.getSize(), out.getData(), prefetchDistance);
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::scatter(const DynamicArray<size_t>& indices, const DynamicArray<T, Alignment>& values, size_t prefetchDistance)
+{
+	if (indices.getSize() != values.getSize())
+		throw std::invalid_argument("Indices and values have different sizes\n");
+
+	scatterElements(getData(), indices.getData(), indices.getSize(), values.getData(), prefetchDistance);
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::gatherSorted(const DynamicArray<size_t>& indices, DynamicArray<T, Alignment>& out) const
+{
+	out.resize(indices.getSize());
+
+	for (size_t begin = 0; begin < indices.getSize(); begin += GATHER_SORT_BATCH) {
+		size_t end = std::min(begin + GATHER_SORT_BATCH, indices.getSize());
+		DynamicArray<size_t> order = sortedOrder(indices, begin, end);
+		gatherInOrder(getData(), indices.getData(), order.getData(), order.getSize(), out.getData(), GATHER_PREFETCH_DISTANCE);
+	}
+}
+
+template<class T, size_t Alignment>
+inline void DynamicArray<T, Alignment>::scatterSorted(const DynamicArray<size_t>& indices, const DynamicArray<T, Alignment>& values)
+{
+	if (indices.getSize() != values.getSize())
+		throw std::invalid_argument("Indices and values have different sizes\n");
+
+	// Batches are written in order and the sort is stable, so repeated indices keep the last value
+	for (size_t begin = 0; begin < indices.getSize(); begin += GATHER_SORT_BATCH) {
+		size_t end = std::min(begin + GATHER_SORT_BATCH, indices.getSize());
+		DynamicArray<size_t> order = sortedOrder(indices, begin, end);
+		scatterInOrder(getData(), indices.getData(), order.getData(), order.getSize(), values.getData(), GATHER_PREFETCH_DISTANCE);
+	}
+}
+
+template<class T, size_t Alignment>
+inline DynamicArray<size_t> DynamicArray<T, Alignment>::sortedOrder(const DynamicArray<size_t>& indices, size_t begin, size_t end)
+{
+	DynamicArray<size_t> order(end - begin);
+	for (size_t i = begin; i < end; ++i)
+		order.push_back(i);
+
+	std::stable_sort(order.getData(), order.getData() + order.getSize(),
+		[&](size_t a, size_t b) { return indices[a] < indices[b]; });
+	return order;
+}
+
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::copy(const DynamicArray<T, Alignment>& other)
 {
 	if (data.getCap() < other.size) {
 		data.clear();
@@ -203,16 +339,23 @@ inline void DynamicArray<T>::copy(const DynamicArray<T>& other)
 		data.reserve(0, other.size);
 	}
 
-	for (int i = 0; i < other.size; ++i) {
-		data[i] = other.data[i];
-	}
+	data.copyRange(data.getData(), other.data.getData(), other.size);
 
 	size = other.size;
 }
 
-template<class T>
-inline void DynamicArray<T>::clear()
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::clear()
 {
 	size = 0;
 	data.clear();
+}
+
+template<class T, size_t Alignment>
+DYNAMIC_ARRAY_CONSTEXPR inline void DynamicArray<T, Alignment>::shrinkIfSparse()
+{
+	if (size >= data.getCap() * shrinkPolicy.threshold)
+		return;
+
+	data.shrink(size, (size_t)(size * shrinkPolicy.target));
 }
\ No newline at end of file
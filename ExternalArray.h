@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "DynamicArray.h"
+#include "SpillFile.h"
+
+//! Default page size of ExternalArray in bytes
+static constexpr size_t EXTERNAL_PAGE_BYTES = (size_t)1 << 20;
+
+//! Default number of pages ExternalArray keeps in memory
+static constexpr size_t EXTERNAL_WINDOW_PAGES = 64;
+
+/**
+* \brief Array which keeps only a bounded window of its elements in memory
+*
+* The elements are split into pages of a fixed number of elements. At most windowPages pages are
+* held in memory frames, the rest live in an anonymous temporary file. Accessing a page which is
+* not in memory evicts the least recently used page, writing it out first if it was modified.
+*
+* When pages are accessed in increasing order, the next page is read ahead in the background.
+* push_back writes every page it fills in the background as well, so appending runs at the speed
+* of the disk without waiting for it. Elements are stored as raw bytes, so T must be trivially
+* copyable. Elements are returned by value, because a reference would not survive the eviction of
+* its page. The array is not thread safe.
+*/
+template <class T>
+class ExternalArray
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Elements are spilled as raw bytes");
+
+public:
+
+	//! Number of elements in a page of EXTERNAL_PAGE_BYTES bytes, at least 1
+	static constexpr size_t DEFAULT_PAGE_ELEMENTS = sizeof(T) < EXTERNAL_PAGE_BYTES ? EXTERNAL_PAGE_BYTES / sizeof(T) : 1;
+
+	/**
+	* \brief Constructs an empty array
+	*
+	* At most windowPages pages of pageElements elements are kept in memory. If pageElements is 0
+	* or windowPages is less than 2, throws an invalid_argument exception
+	*/
+	explicit ExternalArray(size_t pageElements = DEFAULT_PAGE_ELEMENTS, size_t windowPages = EXTERNAL_WINDOW_PAGES);
+	ExternalArray(const ExternalArray&) = delete;
+	ExternalArray& operator=(const ExternalArray&) = delete;
+	//! Waits for the background transfers and removes the temporary file
+	~ExternalArray();
+
+	/**
+	* \brief Read an element at given position
+	*
+	* Loads its page if needed. If the position is invalid, throws an out_of_range exception
+	*/
+	T get(size_t position);
+
+	/**
+	* \brief Overwrite an element at given position
+	*
+	* Loads its page if needed. If the position is invalid, throws an out_of_range exception
+	*/
+	void set(size_t position, const T& value);
+
+	//! Add an element. A page filled by it is written out in the background
+	void push_back(const T& element);
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+	//! Return the number of elements in a page
+	size_t getPageElements() const;
+	//! Return the maximal number of pages in memory
+	size_t getWindowPages() const;
+	//! Return the number of pages read from the file, including read-ahead
+	size_t getPagesRead() const;
+	//! Return the number of pages written to the file
+	size_t getPagesWritten() const;
+
+private:
+
+	static constexpr size_t NO_FRAME = SIZE_MAX;
+
+	//! Memory for one page
+	struct Frame
+	{
+		DynamicArray<T> elements;
+		size_t page = NO_FRAME;        //!< Page held by the frame, NO_FRAME if none
+		bool dirty = false;            //!< Modified since it was last written
+		uint64_t lastUse = 0;          //!< Value of the access clock at the last access
+		std::future<void> pending;     //!< Background read or write of the frame
+		bool reading = false;          //!< The background transfer is a read
+	};
+
+	//! Returns the frame holding the page, loading it if needed. Waits for its background transfer
+	Frame& access(size_t page);
+	/**
+	* \brief Returns the least recently used frame after detaching its page
+	*
+	* A failed read-ahead into the frame is dropped, a failed write is rethrown
+	*/
+	Frame& evict();
+	//! Reads the page after the given one into a free frame in the background
+	void readAhead(size_t page);
+	/**
+	* \brief Waits for the background transfer of the frame
+	*
+	* Rethrows its failure. A frame whose read failed is detached from its page, a frame whose write
+	* failed stays dirty
+	*/
+	void settle(Frame& frame);
+	//! Starts writing the frame in the background
+	void writeBehind(Frame& frame);
+	//! Offset of a page in the file
+	uint64_t offsetOf(size_t page) const;
+
+
+	// Class members:
+
+	size_t size;
+	size_t pageElements;
+	size_t windowPages;
+
+	std::unique_ptr<Frame[]> frames;
+	DynamicArray<size_t> frameOf; //!< Frame of each page, NO_FRAME if the page is only in the file
+	uint64_t clock;               //!< Increased on every access, orders the frames for eviction
+	size_t lastPage;              //!< Page of the previous access, to detect sequential scans
+
+	size_t pagesRead;
+	size_t pagesWritten;
+
+	SpillFile file;
+};
+
+#include "ExternalArray.ipp"
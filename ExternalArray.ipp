@@ -0,0 +1,226 @@
+#include "ExternalArray.h"
+
+template <class T>
+inline ExternalArray<T>::ExternalArray(size_t pageElements, size_t windowPages)
+	: size(0), pageElements(pageElements), windowPages(windowPages), clock(0), lastPage(NO_FRAME), pagesRead(0), pagesWritten(0)
+{
+	if (pageElements == 0)
+		throw std::invalid_argument("Pages must hold at least one element\n");
+	if (windowPages < 2)
+		throw std::invalid_argument("The window must hold at least two pages\n");
+
+	frames.reset(new Frame[windowPages]);
+	for (size_t i = 0; i < windowPages; ++i)
+		frames[i].elements.resize(pageElements);
+}
+
+template <class T>
+inline ExternalArray<T>::~ExternalArray()
+{
+	for (size_t i = 0; i < windowPages; ++i) {
+		try {
+			settle(frames[i]);
+		}
+		catch (...) {
+		}
+	}
+}
+
+template <class T>
+inline T ExternalArray<T>::get(size_t position)
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return access(position / pageElements).elements[position % pageElements];
+}
+
+template <class T>
+inline void ExternalArray<T>::set(size_t position, const T& value)
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	Frame& frame = access(position / pageElements);
+	frame.elements[position % pageElements] = value;
+	frame.dirty = true;
+}
+
+template <class T>
+inline void ExternalArray<T>::push_back(const T& element)
+{
+	// A new page needs a frame but nothing from the file
+	if (size == frameOf.getSize() * pageElements) {
+		Frame& frame = evict();
+		frame.page = frameOf.getSize();
+		frameOf.push_back(&frame - frames.get());
+		frame.lastUse = ++clock;
+		lastPage = frame.page;
+	}
+
+	Frame& frame = access(size / pageElements);
+	frame.elements[size % pageElements] = element;
+	frame.dirty = true;
+	++size;
+
+	if (size % pageElements == 0)
+		writeBehind(frame);
+}
+
+template <class T>
+inline bool ExternalArray<T>::empty() const
+{
+	return size == 0;
+}
+
+template <class T>
+inline size_t ExternalArray<T>::getSize() const
+{
+	return size;
+}
+
+template <class T>
+inline size_t ExternalArray<T>::getPageElements() const
+{
+	return pageElements;
+}
+
+template <class T>
+inline size_t ExternalArray<T>::getWindowPages() const
+{
+	return windowPages;
+}
+
+template <class T>
+inline size_t ExternalArray<T>::getPagesRead() const
+{
+	return pagesRead;
+}
+
+template <class T>
+inline size_t ExternalArray<T>::getPagesWritten() const
+{
+	return pagesWritten;
+}
+
+template <class T>
+inline typename ExternalArray<T>::Frame& ExternalArray<T>::access(size_t page)
+{
+	Frame* frame;
+	if (frameOf[page] != NO_FRAME) {
+		frame = &frames[frameOf[page]];
+		settle(*frame);
+	}
+	else {
+		frame = &evict();
+		file.read(frame->elements.getData(), pageElements * sizeof(T), offsetOf(page));
+		++pagesRead;
+		frame->page = page;
+		frameOf[page] = frame - frames.get();
+	}
+
+	frame->lastUse = ++clock;
+	if (page != lastPage) {
+		bool sequential = page == lastPage + 1;
+		lastPage = page;
+		if (sequential)
+			readAhead(page);
+	}
+
+	return *frame;
+}
+
+template <class T>
+inline typename ExternalArray<T>::Frame& ExternalArray<T>::evict()
+{
+	// Frames which never held a page have lastUse 0 and go first
+	Frame* victim = &frames[0];
+	for (size_t i = 1; i < windowPages; ++i)
+		if (frames[i].lastUse < victim->lastUse)
+			victim = &frames[i];
+
+	if (victim->reading) {
+		// Nobody asked for the page yet, a failed read-ahead only loses it. It is read again on access
+		try {
+			settle(*victim);
+		}
+		catch (...) {
+		}
+	}
+	else
+		settle(*victim);
+
+	if (victim->page != NO_FRAME) {
+		if (victim->dirty) {
+			file.write(victim->elements.getData(), pageElements * sizeof(T), offsetOf(victim->page));
+			++pagesWritten;
+			victim->dirty = false;
+		}
+		frameOf[victim->page] = NO_FRAME;
+		victim->page = NO_FRAME;
+	}
+
+	return *victim;
+}
+
+template <class T>
+inline void ExternalArray<T>::readAhead(size_t page)
+{
+	size_t next = page + 1;
+	if (next >= frameOf.getSize() || frameOf[next] != NO_FRAME)
+		return;
+
+	// The frame of the current page is the most recently used one, so it is not the victim
+	Frame& frame = evict();
+	frame.page = next;
+	frame.lastUse = ++clock;
+	frameOf[next] = &frame - frames.get();
+
+	SpillFile* spill = &file;
+	T* target = frame.elements.getData();
+	size_t bytes = pageElements * sizeof(T);
+	uint64_t offset = offsetOf(next);
+	frame.reading = true;
+	frame.pending = std::async(std::launch::async, [=]() { spill->read(target, bytes, offset); });
+	++pagesRead;
+}
+
+template <class T>
+inline void ExternalArray<T>::writeBehind(Frame& frame)
+{
+	SpillFile* spill = &file;
+	const T* source = frame.elements.getData();
+	size_t bytes = pageElements * sizeof(T);
+	uint64_t offset = offsetOf(frame.page);
+	frame.reading = false;
+	frame.pending = std::async(std::launch::async, [=]() { spill->write(source, bytes, offset); });
+	frame.dirty = false;
+	++pagesWritten;
+}
+
+template <class T>
+inline void ExternalArray<T>::settle(Frame& frame)
+{
+	if (!frame.pending.valid())
+		return;
+
+	try {
+		frame.pending.get();
+	}
+	catch (...) {
+		if (!frame.reading)
+			frame.dirty = true;
+		else if (frame.page != NO_FRAME) {
+			frameOf[frame.page] = NO_FRAME;
+			frame.page = NO_FRAME;
+			frame.lastUse = 0;
+		}
+		throw;
+	}
+}
+
+template <class T>
+inline uint64_t ExternalArray<T>::offsetOf(size_t page) const
+{
+	return (uint64_t)page * pageElements * sizeof(T);
+}
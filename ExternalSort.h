@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "DynamicArray.h"
+#include "Parallel.h"
+#include "SpillFile.h"
+
+/*
+* Sorting of files larger than memory.
+*
+* The input is a file of raw records of type T, as written by saveAsync(). It is read in runs which
+* fill half of the memory budget. Each run is sorted by all threads and written to a temporary file
+* while the next run is read and sorted in the other half. The runs are then merged in one pass
+* through a loser tree, each run read through its own large buffer, into the output file.
+*/
+
+//! A parallel sort gives each thread at least that many elements
+static constexpr size_t PARALLEL_SORT_MIN_PART = 4096;
+
+//! Smallest read buffer per run during the merge, in bytes
+static constexpr size_t EXTERNAL_SORT_MIN_BUFFER = (size_t)64 << 10;
+
+//! Settings of an external sort
+struct ExternalSortOptions
+{
+	size_t memoryBytes = (size_t)256 << 20; //!< Memory for the run buffers, shared by the merge buffers afterwards
+	unsigned threads = hardwareThreads();   //!< Threads sorting each run
+};
+
+//! I/O volume and duration of one phase of an external sort
+struct SortPhase
+{
+	uint64_t bytesRead = 0;
+	uint64_t bytesWritten = 0;
+	double seconds = 0;
+};
+
+//! Report of an external sort
+struct ExternalSortStats
+{
+	size_t elements = 0;  //!< Number of records sorted
+	size_t runs = 0;      //!< Number of sorted runs. With a single run the merge phase is skipped
+	SortPhase runPhase;   //!< Reading the input, sorting and writing the runs
+	SortPhase mergePhase; //!< Merging the runs into the output
+};
+
+/**
+* \brief Tournament tree which selects the smallest of k sorted sequences
+*
+* Each internal node keeps the loser of the match played there and the winner moves on, so after
+* the winner is replaced by the next element of its sequence only the matches on its path to the
+* root are replayed: log2(k) comparisons against fixed opponents, without the sibling comparisons
+* of a binary heap. Sequences are represented by a pointer to their current element, nullptr once
+* they are exhausted. Ties go to the sequence with the lower index, so merging is stable.
+*/
+template <class T, class Compare>
+class LoserTree
+{
+public:
+
+	//! Creates a tree for k sequences, all exhausted
+	LoserTree(size_t k, Compare compare);
+
+	//! Set the current element of a sequence. Call build() after setting all of them
+	void setHead(size_t sequence, const T* head);
+	//! Plays all matches
+	void build();
+
+	//! Return the sequence with the smallest current element
+	size_t getWinner() const;
+	//! Return the current element of a sequence, nullptr if it is exhausted
+	const T* getHead(size_t sequence) const;
+
+	//! Replace the current element of the winner and replay its matches
+	void replaceWinner(const T* head);
+
+private:
+
+	//! Check if sequence a wins against sequence b. The index k is a virtual sequence which beats all
+	bool beats(size_t a, size_t b) const;
+	//! Plays the matches of a sequence from its leaf to the root
+	void replay(size_t sequence);
+
+
+	// Class members:
+
+	size_t k;
+	DynamicArray<const T*> heads;
+	DynamicArray<size_t> losers; //!< losers[0] is the overall winner, losers[1..k-1] the internal nodes
+	Compare compare;
+};
+
+/**
+* \brief Sorts count elements with the given number of threads
+*
+* Each thread sorts a contiguous part, then the parts are merged. compare must not throw.
+*/
+template <class T, class Compare = std::less<T>>
+void sortParallel(T* data, size_t count, unsigned threads, Compare compare = Compare());
+
+/**
+* \brief Sorts the records of a file into another file
+*
+* Both files hold raw records of T. The output must be a different file than the input. If the
+* input size is not a multiple of the record size, or the memory budget holds less than two records,
+* throws an invalid_argument exception. I/O failures throw a runtime_error exception.
+* The merge buffers get at least EXTERNAL_SORT_MIN_BUFFER bytes each, so inputs of very many runs
+* use more memory than the budget.
+*/
+template <class T, class Compare = std::less<T>>
+ExternalSortStats externalSort(const std::string& input, const std::string& output,
+	const ExternalSortOptions& options = ExternalSortOptions(), Compare compare = Compare());
+
+#include "ExternalSort.ipp"
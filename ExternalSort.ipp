@@ -0,0 +1,267 @@
+#include "ExternalSort.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+
+template <class T, class Compare>
+inline LoserTree<T, Compare>::LoserTree(size_t k, Compare compare)
+	: k(k), compare(compare)
+{
+	heads.resize(k, nullptr);
+	losers.resize(k == 0 ? 1 : k, k);
+}
+
+template <class T, class Compare>
+inline void LoserTree<T, Compare>::setHead(size_t sequence, const T* head)
+{
+	heads[sequence] = head;
+}
+
+template <class T, class Compare>
+inline void LoserTree<T, Compare>::build()
+{
+	// Every node starts with the virtual sequence k, which wins all its matches, so each
+	// sequence inserted from the leaves stops at the first node still holding k
+	for (size_t i = 0; i < losers.getSize(); ++i)
+		losers[i] = k;
+	for (size_t sequence = k; sequence-- > 0; )
+		replay(sequence);
+}
+
+template <class T, class Compare>
+inline size_t LoserTree<T, Compare>::getWinner() const
+{
+	return losers[0];
+}
+
+template <class T, class Compare>
+inline const T* LoserTree<T, Compare>::getHead(size_t sequence) const
+{
+	return sequence < k ? heads[sequence] : nullptr;
+}
+
+template <class T, class Compare>
+inline void LoserTree<T, Compare>::replaceWinner(const T* head)
+{
+	heads[losers[0]] = head;
+	replay(losers[0]);
+}
+
+template <class T, class Compare>
+inline bool LoserTree<T, Compare>::beats(size_t a, size_t b) const
+{
+	if (a == k)
+		return true;
+	if (b == k)
+		return false;
+
+	const T* x = heads[a];
+	const T* y = heads[b];
+	if (!x || !y)
+		return x != nullptr || (y == nullptr && a < b);
+	if (compare(*x, *y))
+		return true;
+	if (compare(*y, *x))
+		return false;
+	return a < b;
+}
+
+template <class T, class Compare>
+inline void LoserTree<T, Compare>::replay(size_t sequence)
+{
+	for (size_t node = (sequence + k) / 2; node > 0; node /= 2)
+		if (beats(losers[node], sequence))
+			std::swap(sequence, losers[node]);
+
+	losers[0] = sequence;
+}
+
+template <class T, class Compare>
+inline void sortParallel(T* data, size_t count, unsigned threads, Compare compare)
+{
+	size_t parts = std::min<size_t>(threads, count / PARALLEL_SORT_MIN_PART);
+	if (parts <= 1) {
+		std::sort(data, data + count, compare);
+		return;
+	}
+
+	parallelFor(count, (unsigned)parts, [data, compare](size_t begin, size_t end) {
+		std::sort(data + begin, data + end, compare);
+	});
+
+	// Part i is [count * i / parts, count * (i + 1) / parts), as split by parallelFor
+	for (size_t width = 1; width < parts; width *= 2)
+		for (size_t i = 0; i + width < parts; i += 2 * width) {
+			size_t last = std::min(i + 2 * width, parts);
+			std::inplace_merge(data + count * i / parts, data + count * (i + width) / parts, data + count * last / parts, compare);
+		}
+}
+
+template <class T, class Compare>
+inline ExternalSortStats externalSort(const std::string& input, const std::string& output,
+	const ExternalSortOptions& options, Compare compare)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Records are sorted as raw bytes");
+
+	typedef std::unique_ptr<std::FILE, int(*)(std::FILE*)> File;
+	typedef std::chrono::steady_clock Clock;
+
+	size_t runElements = options.memoryBytes / 2 / sizeof(T);
+	if (runElements == 0)
+		throw std::invalid_argument("Memory budget must hold at least two records\n");
+
+	auto writeAll = [](std::FILE* file, const T* data, size_t count) {
+		if (std::fwrite(data, sizeof(T), count, file) != count)
+			throw std::runtime_error("Cannot write the output file\n");
+	};
+
+	ExternalSortStats stats;
+	Clock::time_point start = Clock::now();
+
+	File in(std::fopen(input.c_str(), "rb"), std::fclose);
+	if (!in)
+		throw std::runtime_error("Cannot open " + input + "\n");
+	File out(std::fopen(output.c_str(), "wb"), std::fclose);
+	if (!out)
+		throw std::runtime_error("Cannot open " + output + "\n");
+
+	// Phase 1: one half of the memory is sorted while the other half is written out as the previous run
+	SpillFile runs;
+	DynamicArray<size_t> runSizes;
+	DynamicArray<T> halves[2];
+	halves[0].resize(runElements);
+	halves[1].resize(runElements);
+	{
+		std::future<void> writing;
+		uint64_t offset = 0;
+
+		for (size_t current = 0; ; current ^= 1) {
+			T* data = halves[current].getData();
+			size_t bytes = std::fread(data, 1, runElements * sizeof(T), in.get());
+			if (std::ferror(in.get()))
+				throw std::runtime_error("Cannot read " + input + "\n");
+			if (bytes % sizeof(T) != 0)
+				throw std::invalid_argument("Input size is not a multiple of the record size\n");
+			if (bytes == 0)
+				break;
+
+			size_t count = bytes / sizeof(T);
+			stats.elements += count;
+			stats.runPhase.bytesRead += bytes;
+			sortParallel(data, count, options.threads, compare);
+
+			if (writing.valid())
+				writing.get();
+
+			// An input which fits in one run is written straight to the output
+			if (runSizes.empty() && count < runElements) {
+				writeAll(out.get(), data, count);
+				stats.runPhase.bytesWritten += bytes;
+				stats.runs = 1;
+				break;
+			}
+
+			SpillFile* spill = &runs;
+			writing = std::async(std::launch::async, [spill, data, bytes, offset]() { spill->write(data, bytes, offset); });
+			runSizes.push_back(count);
+			offset += bytes;
+			stats.runPhase.bytesWritten += bytes;
+
+			if (count < runElements)
+				break;
+		}
+
+		if (writing.valid())
+			writing.get();
+	}
+	halves[0] = DynamicArray<T>();
+	halves[1] = DynamicArray<T>();
+	stats.runPhase.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	if (stats.runs == 1 || runSizes.empty()) {
+		if (std::fclose(out.release()) != 0)
+			throw std::runtime_error("Cannot write the output file\n");
+		return stats;
+	}
+
+	// Phase 2: k-way merge, each run and the output with a buffer of an equal share of the memory
+	start = Clock::now();
+	size_t k = runSizes.getSize();
+	stats.runs = k;
+	size_t bufferElements = std::max(options.memoryBytes / (k + 1), EXTERNAL_SORT_MIN_BUFFER) / sizeof(T);
+	if (bufferElements == 0)
+		bufferElements = 1;
+
+	DynamicArray<DynamicArray<T>> buffers;
+	DynamicArray<uint64_t> offsets;
+	DynamicArray<size_t> remaining;
+	DynamicArray<size_t> positions;
+	DynamicArray<size_t> filled;
+	buffers.resize(k);
+	offsets.resize(k);
+	remaining.resize(k);
+	positions.resize(k, 0);
+	filled.resize(k, 0);
+
+	uint64_t offset = 0;
+	for (size_t i = 0; i < k; ++i) {
+		buffers[i].resize(std::min(bufferElements, runSizes[i]));
+		offsets[i] = offset;
+		remaining[i] = runSizes[i];
+		offset += (uint64_t)runSizes[i] * sizeof(T);
+	}
+
+	auto refill = [&](size_t run) {
+		size_t count = std::min(buffers[run].getSize(), remaining[run]);
+		runs.read(buffers[run].getData(), count * sizeof(T), offsets[run]);
+		offsets[run] += (uint64_t)count * sizeof(T);
+		remaining[run] -= count;
+		positions[run] = 0;
+		filled[run] = count;
+		stats.mergePhase.bytesRead += count * sizeof(T);
+	};
+
+	LoserTree<T, Compare> tree(k, compare);
+	for (size_t i = 0; i < k; ++i) {
+		refill(i);
+		tree.setHead(i, buffers[i].getData());
+	}
+	tree.build();
+
+	DynamicArray<T> merged;
+	merged.resize(bufferElements);
+	size_t mergedCount = 0;
+
+	for (;;) {
+		size_t winner = tree.getWinner();
+		const T* head = tree.getHead(winner);
+		if (!head)
+			break;
+
+		merged[mergedCount++] = *head;
+		if (mergedCount == bufferElements) {
+			writeAll(out.get(), merged.getData(), mergedCount);
+			stats.mergePhase.bytesWritten += mergedCount * sizeof(T);
+			mergedCount = 0;
+		}
+
+		if (++positions[winner] == filled[winner]) {
+			if (remaining[winner] == 0) {
+				tree.replaceWinner(nullptr);
+				continue;
+			}
+			refill(winner);
+		}
+		tree.replaceWinner(buffers[winner].getData() + positions[winner]);
+	}
+
+	writeAll(out.get(), merged.getData(), mergedCount);
+	stats.mergePhase.bytesWritten += mergedCount * sizeof(T);
+	if (std::fclose(out.release()) != 0)
+		throw std::runtime_error("Cannot write the output file\n");
+
+	stats.mergePhase.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return stats;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <functional>
+#include "Bits.h"
+#include "DynamicArray.h"
+#include "Prefetch.h"
+
+/**
+* \brief Read-only search index in Eytzinger layout
+*
+* Built from a sorted dynamic array. The keys are stored in the order of a breadth-first traversal
+* of the implicit binary search tree (position k has children 2k and 2k + 1), so the first levels
+* of every search share the same few cache lines. The search loop is branchless and prefetches
+* the descendants a few levels ahead, so the cache misses of consecutive levels overlap.
+* The results are positions in the original sorted array.
+*/
+template <class T, class Compare = std::less<T>>
+class EytzingerIndex
+{
+private:
+	//! Descendants that many levels below fit in one cache line and are prefetched together
+	static constexpr size_t PREFETCH_STRIDE = sizeof(T) >= CACHE_LINE_SIZE ? 1 : CACHE_LINE_SIZE / sizeof(T);
+
+public:
+
+	//! Builds the index from the elements of a sorted array
+	EytzingerIndex(const DynamicArray<T>& sorted);
+
+	//! Position in the sorted array of the first element not less than key, or size if there is none
+	size_t lower_bound(const T& key) const;
+
+	//! Position in the sorted array of the first element greater than key, or size if there is none
+	size_t upper_bound(const T& key) const;
+
+	/**
+	* \brief Range query
+	*
+	* Returns the number of elements in the range [low, high]. The first of them is at position lower_bound(low).
+	*/
+	size_t count(const T& low, const T& high) const;
+
+	//! Return the key at the given position of the sorted order
+	const T& getSorted(size_t position) const;
+
+	//! Return size
+	size_t getSize() const;
+
+private:
+
+	//! Fills the subtree rooted at k with the next elements of the sorted array in order
+	void build(const DynamicArray<T>& sorted, size_t k, size_t& next);
+
+	//! Descends to a leaf and returns the tree position of the answer, 0 if there is none
+	template <class Less>
+	size_t search(const T& key, Less goRight) const;
+
+
+	// Class members:
+
+	DynamicArray<T> keys;       //!< keys[k] for k in [1, size]. keys[0] is not used
+	DynamicArray<size_t> ranks; //!< Position in the sorted array of keys[k]
+	size_t size;
+	Compare less;
+};
+
+#include "EytzingerIndex.ipp"
@@ -0,0 +1,84 @@
+#include "EytzingerIndex.h"
+
+template<class T, class Compare>
+inline EytzingerIndex<T, Compare>::EytzingerIndex(const DynamicArray<T>& sorted) : keys(), ranks(), size(sorted.getSize()), less()
+{
+	keys.resize(size + 1);
+	ranks.resize(size + 1);
+
+	size_t next = 0;
+	build(sorted, 1, next);
+}
+
+template<class T, class Compare>
+inline size_t EytzingerIndex<T, Compare>::lower_bound(const T& key) const
+{
+	const Compare& compare = less;
+	size_t k = search(key, [&compare](const T& node, const T& value) { return compare(node, value); });
+	return k == 0 ? size : ranks[k];
+}
+
+template<class T, class Compare>
+inline size_t EytzingerIndex<T, Compare>::upper_bound(const T& key) const
+{
+	const Compare& compare = less;
+	size_t k = search(key, [&compare](const T& node, const T& value) { return !compare(value, node); });
+	return k == 0 ? size : ranks[k];
+}
+
+template<class T, class Compare>
+inline size_t EytzingerIndex<T, Compare>::count(const T& low, const T& high) const
+{
+	size_t first = lower_bound(low);
+	size_t last = upper_bound(high);
+	return last > first ? last - first : 0;
+}
+
+template<class T, class Compare>
+inline const T& EytzingerIndex<T, Compare>::getSorted(size_t position) const
+{
+	// The ranks are ordered like the keys, so the node is found by searching with the position as the key
+	size_t k = 1;
+	while (ranks[k] != position)
+		k = 2 * k + (ranks[k] < position ? 1 : 0);
+
+	return keys[k];
+}
+
+template<class T, class Compare>
+inline size_t EytzingerIndex<T, Compare>::getSize() const
+{
+	return size;
+}
+
+template<class T, class Compare>
+inline void EytzingerIndex<T, Compare>::build(const DynamicArray<T>& sorted, size_t k, size_t& next)
+{
+	if (k > size)
+		return;
+
+	// In-order traversal of the implicit tree visits the positions in sorted order
+	build(sorted, 2 * k, next);
+	keys[k] = sorted[next];
+	ranks[k] = next;
+	++next;
+	build(sorted, 2 * k + 1, next);
+}
+
+template<class T, class Compare>
+template<class Less>
+inline size_t EytzingerIndex<T, Compare>::search(const T& key, Less goRight) const
+{
+	const T* base = keys.getData();
+	size_t k = 1;
+
+	while (k <= size) {
+		size_t ahead = k * PREFETCH_STRIDE;
+		prefetch(base + (ahead < size ? ahead : size));
+		k = 2 * k + (goRight(base[k], key) ? 1 : 0);
+	}
+
+	// The answer is the last node where the search went left. Its position is k without the trailing ones and the last zero
+	k >>= countTrailingZeros(~(uint64_t)k) + 1;
+	return k;
+}
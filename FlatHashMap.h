@@ -0,0 +1,181 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include "Bits.h"
+#include "Container.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+* \brief Open addressing hash map with the keys and the values stored in flat buffers
+*
+* Follows the Swiss table design. Every slot has a control byte, which is either empty, deleted
+* or the lowest 7 bits of the hash of its key. A lookup compares 16 control bytes at a time
+* (with a single SSE2 instruction where available) and reads only the keys whose bytes match.
+* On erase the slot is marked empty whenever no probe sequence could have passed through it,
+* so tombstones are left only inside full groups. The table grows when 7/8 of the slots are used.
+*/
+template <class K, class V, class Hash = std::hash<K>, class Equal = std::equal_to<K>>
+class FlatHashMap
+{
+private:
+	static constexpr size_t GROUP_WIDTH = 16;
+	static constexpr size_t MIN_CAPACITY = 16;
+	static constexpr size_t NOT_FOUND = (size_t)-1;
+
+	static constexpr int8_t EMPTY = -128;
+	static constexpr int8_t DELETED = -2;
+
+	class Group;
+
+public:
+
+	//! Default constructor
+	FlatHashMap();
+	//! Constructs the object with room for the given number of entries
+	FlatHashMap(size_t entries);
+	//! Copy constructor
+	FlatHashMap(const FlatHashMap& other);
+
+	//! Operator =
+	FlatHashMap& operator=(const FlatHashMap& other);
+
+	/**
+	* \brief Access a value by key
+	*
+	* If the key is missing, it is inserted with a default constructed value
+	*/
+	V& operator[](const K& key);
+
+	/**
+	* \brief Access a value by key
+	*
+	* If the key is missing, throws an out_of_range exception
+	*/
+	const V& at(const K& key) const;
+
+	/**
+	* \brief Access a value by key
+	*
+	* If the key is missing, throws an out_of_range exception
+	*/
+	V& at(const K& key);
+
+	//! Returns a pointer to the value of the key, nullptr if it is missing
+	const V* find(const K& key) const;
+	//! Returns a pointer to the value of the key, nullptr if it is missing
+	V* find(const K& key);
+
+	//! Check if the key is in the map
+	bool contains(const K& key) const;
+
+	/**
+	* \brief Add an entry
+	*
+	* \return True if the entry was added
+	* \return False if the key was already in the map. Its value is not changed
+	*/
+	bool insert(const K& key, const V& value);
+
+	/**
+	* \brief Remove an entry
+	*
+	* \return True if the entry was removed
+	* \return False if the key was not in the map
+	*/
+	bool erase(const K& key);
+
+	/**
+	* \brief Reserve extra space
+	*
+	* Rehashes the table so that the given number of entries fit without growing.
+	*/
+	void reserve(size_t entries);
+
+	//! Calls f(key, value) for every entry, in slot order
+	template <class F>
+	void forEach(F f) const;
+
+	/**
+	* \brief Check if the map is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return the number of entries
+	size_t getSize() const;
+	//! Return the number of slots
+	size_t getCapacity() const;
+
+private:
+
+	//! Mixes the bits of the user hash, so both the position and the control byte are well distributed
+	size_t hashOf(const K& key) const;
+	static size_t position(size_t hash);
+	static int8_t controlByte(size_t hash);
+
+	//! Number of entries which fit in the given number of slots
+	static size_t maxEntries(size_t capacity);
+
+	//! Slot of the key, NOT_FOUND if it is missing
+	size_t findSlot(const K& key, size_t hash) const;
+	//! First empty or deleted slot in the probe sequence of the hash
+	size_t findInsertSlot(size_t hash) const;
+	//! Stores a new entry, the key must not be in the map
+	size_t insertNew(const K& key, const V& value, size_t hash);
+	//! Sets a control byte and its clone after the end of the table
+	void setControl(size_t slot, int8_t control);
+
+	//! Moves all entries to a table with the given number of slots
+	void rehash(size_t newCapacity);
+	//! Copies the data of other object
+	void copy(const FlatHashMap& other);
+
+	//! Moves a slot to a new table. Trivially copyable types are copied as raw bytes
+	template <class T>
+	static void relocate(T& target, const T& source, std::true_type);
+	template <class T>
+	static void relocate(T& target, const T& source, std::false_type);
+
+
+	// Class members:
+
+	Container<int8_t> control; //!< capacity control bytes followed by clones of the first GROUP_WIDTH - 1
+	Container<K> keys;
+	Container<V> values;
+	size_t capacity;   //!< Number of slots, a power of two or 0
+	size_t size;       //!< Number of entries
+	size_t growthLeft; //!< Number of empty slots which may be filled before the table grows
+	Hash hasher;
+	Equal equal;
+};
+
+//! Control bytes of GROUP_WIDTH consecutive slots
+template <class K, class V, class Hash, class Equal>
+class FlatHashMap<K, V, Hash, Equal>::Group
+{
+public:
+	Group(const int8_t* control);
+
+	//! Bit i is set if the control byte of slot i equals the given one
+	uint32_t match(int8_t byte) const;
+	//! Bit i is set if slot i is empty
+	uint32_t matchEmpty() const;
+	//! Bit i is set if slot i is empty or deleted
+	uint32_t matchEmptyOrDeleted() const;
+
+private:
+#ifdef FLAT_HASH_MAP_SSE2
+	__m128i bytes;
+#else
+	const int8_t* bytes;
+#endif
+};
+
+#include "FlatHashMap.ipp"
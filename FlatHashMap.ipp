@@ -0,0 +1,358 @@
+#include "FlatHashMap.h"
+#include <cstring>
+#include <type_traits>
+
+template<class K, class V, class Hash, class Equal>
+inline FlatHashMap<K, V, Hash, Equal>::Group::Group(const int8_t* control)
+{
+#ifdef FLAT_HASH_MAP_SSE2
+	bytes = _mm_loadu_si128((const __m128i*)control);
+#else
+	bytes = control;
+#endif
+}
+
+template<class K, class V, class Hash, class Equal>
+inline uint32_t FlatHashMap<K, V, Hash, Equal>::Group::match(int8_t byte) const
+{
+#ifdef FLAT_HASH_MAP_SSE2
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(byte), bytes));
+#else
+	uint32_t mask = 0;
+	for (size_t i = 0; i < GROUP_WIDTH; ++i)
+		mask |= (uint32_t)(bytes[i] == byte) << i;
+	return mask;
+#endif
+}
+
+template<class K, class V, class Hash, class Equal>
+inline uint32_t FlatHashMap<K, V, Hash, Equal>::Group::matchEmpty() const
+{
+	return match(EMPTY);
+}
+
+template<class K, class V, class Hash, class Equal>
+inline uint32_t FlatHashMap<K, V, Hash, Equal>::Group::matchEmptyOrDeleted() const
+{
+	// Empty and deleted are the only negative bytes other than -1, which is never used
+#ifdef FLAT_HASH_MAP_SSE2
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), bytes));
+#else
+	uint32_t mask = 0;
+	for (size_t i = 0; i < GROUP_WIDTH; ++i)
+		mask |= (uint32_t)(bytes[i] < -1) << i;
+	return mask;
+#endif
+}
+
+template<class K, class V, class Hash, class Equal>
+inline FlatHashMap<K, V, Hash, Equal>::FlatHashMap() : control(), keys(), values(), capacity(0), size(0), growthLeft(0), hasher(), equal()
+{
+}
+
+template<class K, class V, class Hash, class Equal>
+inline FlatHashMap<K, V, Hash, Equal>::FlatHashMap(size_t entries) : FlatHashMap()
+{
+	reserve(entries);
+}
+
+template<class K, class V, class Hash, class Equal>
+inline FlatHashMap<K, V, Hash, Equal>::FlatHashMap(const FlatHashMap& other) : FlatHashMap()
+{
+	copy(other);
+}
+
+template<class K, class V, class Hash, class Equal>
+inline FlatHashMap<K, V, Hash, Equal>& FlatHashMap<K, V, Hash, Equal>::operator=(const FlatHashMap& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline V& FlatHashMap<K, V, Hash, Equal>::operator[](const K& key)
+{
+	size_t hash = hashOf(key);
+	size_t slot = findSlot(key, hash);
+	if (slot == NOT_FOUND)
+		slot = insertNew(key, V(), hash);
+
+	return values[slot];
+}
+
+template<class K, class V, class Hash, class Equal>
+inline const V& FlatHashMap<K, V, Hash, Equal>::at(const K& key) const
+{
+	const V* value = find(key);
+	if (!value)
+		throw std::out_of_range("Key not found\n");
+
+	return *value;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline V& FlatHashMap<K, V, Hash, Equal>::at(const K& key)
+{
+	return const_cast<V&>(const_cast<const FlatHashMap&>(*this).at(key));
+}
+
+template<class K, class V, class Hash, class Equal>
+inline const V* FlatHashMap<K, V, Hash, Equal>::find(const K& key) const
+{
+	size_t slot = findSlot(key, hashOf(key));
+	return slot == NOT_FOUND ? nullptr : &values[slot];
+}
+
+template<class K, class V, class Hash, class Equal>
+inline V* FlatHashMap<K, V, Hash, Equal>::find(const K& key)
+{
+	return const_cast<V*>(const_cast<const FlatHashMap&>(*this).find(key));
+}
+
+template<class K, class V, class Hash, class Equal>
+inline bool FlatHashMap<K, V, Hash, Equal>::contains(const K& key) const
+{
+	return find(key) != nullptr;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline bool FlatHashMap<K, V, Hash, Equal>::insert(const K& key, const V& value)
+{
+	size_t hash = hashOf(key);
+	if (findSlot(key, hash) != NOT_FOUND)
+		return false;
+
+	insertNew(key, value, hash);
+	return true;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline bool FlatHashMap<K, V, Hash, Equal>::erase(const K& key)
+{
+	size_t slot = findSlot(key, hashOf(key));
+	if (slot == NOT_FOUND)
+		return false;
+
+	// If the empty slots around this one are less than a group apart, every probe which reached
+	// this slot has also seen an empty one and stopped, so the slot can become empty again
+	size_t mask = capacity - 1;
+	uint32_t emptyBefore = Group(&control[(slot - GROUP_WIDTH) & mask]).matchEmpty();
+	uint32_t emptyAfter = Group(&control[slot]).matchEmpty();
+	bool wasNeverFull = emptyBefore && emptyAfter &&
+		countTrailingZeros(emptyAfter) + (GROUP_WIDTH - 1 - highestBit(emptyBefore)) < GROUP_WIDTH;
+
+	setControl(slot, wasNeverFull ? EMPTY : DELETED);
+	if (wasNeverFull)
+		++growthLeft;
+	--size;
+
+	return true;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline void FlatHashMap<K, V, Hash, Equal>::reserve(size_t entries)
+{
+	size_t newCapacity = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+	while (maxEntries(newCapacity) < entries)
+		newCapacity *= 2;
+
+	if (newCapacity > capacity)
+		rehash(newCapacity);
+}
+
+template<class K, class V, class Hash, class Equal>
+template<class F>
+inline void FlatHashMap<K, V, Hash, Equal>::forEach(F f) const
+{
+	for (size_t i = 0; i < capacity; ++i) {
+		if (control[i] >= 0)
+			f(keys[i], values[i]);
+	}
+}
+
+template<class K, class V, class Hash, class Equal>
+inline bool FlatHashMap<K, V, Hash, Equal>::empty() const
+{
+	return size == 0;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::getSize() const
+{
+	return size;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::getCapacity() const
+{
+	return capacity;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::hashOf(const K& key) const
+{
+	uint64_t hash = (uint64_t)hasher(key) * 0x9E3779B97F4A7C15ull;
+	return (size_t)(hash ^ (hash >> 32));
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::position(size_t hash)
+{
+	return hash >> 7;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline int8_t FlatHashMap<K, V, Hash, Equal>::controlByte(size_t hash)
+{
+	return (int8_t)(hash & 0x7F);
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::maxEntries(size_t capacity)
+{
+	return capacity - capacity / 8;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::findSlot(const K& key, size_t hash) const
+{
+	if (capacity == 0)
+		return NOT_FOUND;
+
+	size_t mask = capacity - 1;
+	size_t group = position(hash) & mask;
+	int8_t byte = controlByte(hash);
+
+	// Triangular probing over groups visits every group of a power of two table
+	for (size_t step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+		Group candidates(&control[group]);
+
+		for (uint32_t match = candidates.match(byte); match != 0; match &= match - 1) {
+			size_t slot = (group + countTrailingZeros(match)) & mask;
+			if (equal(keys[slot], key))
+				return slot;
+		}
+
+		if (candidates.matchEmpty() != 0)
+			return NOT_FOUND;
+
+		group = (group + step) & mask;
+	}
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::findInsertSlot(size_t hash) const
+{
+	size_t mask = capacity - 1;
+	size_t group = position(hash) & mask;
+
+	for (size_t step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+		uint32_t match = Group(&control[group]).matchEmptyOrDeleted();
+		if (match != 0)
+			return (group + countTrailingZeros(match)) & mask;
+
+		group = (group + step) & mask;
+	}
+}
+
+template<class K, class V, class Hash, class Equal>
+inline size_t FlatHashMap<K, V, Hash, Equal>::insertNew(const K& key, const V& value, size_t hash)
+{
+	if (capacity == 0)
+		rehash(MIN_CAPACITY);
+
+	size_t slot = findInsertSlot(hash);
+
+	if (growthLeft == 0 && control[slot] == EMPTY) {
+		// Drop the tombstones if they take at least half of the usable slots, otherwise grow
+		rehash(size <= maxEntries(capacity) / 2 ? capacity : capacity * 2);
+		slot = findInsertSlot(hash);
+	}
+
+	if (control[slot] == EMPTY)
+		--growthLeft;
+
+	setControl(slot, controlByte(hash));
+	keys[slot] = key;
+	values[slot] = value;
+	++size;
+
+	return slot;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline void FlatHashMap<K, V, Hash, Equal>::setControl(size_t slot, int8_t byte)
+{
+	control[slot] = byte;
+	if (slot < GROUP_WIDTH - 1)
+		control[capacity + slot] = byte;
+}
+
+template<class K, class V, class Hash, class Equal>
+inline void FlatHashMap<K, V, Hash, Equal>::rehash(size_t newCapacity)
+{
+	Container<int8_t> oldControl(newCapacity + GROUP_WIDTH - 1);
+	Container<K> oldKeys(newCapacity);
+	Container<V> oldValues(newCapacity);
+	control.swap(oldControl);
+	keys.swap(oldKeys);
+	values.swap(oldValues);
+
+	size_t oldCapacity = capacity;
+	capacity = newCapacity;
+	growthLeft = maxEntries(capacity) - size;
+
+	for (size_t i = 0; i < capacity + GROUP_WIDTH - 1; ++i)
+		control[i] = EMPTY;
+
+	for (size_t i = 0; i < oldCapacity; ++i) {
+		if (oldControl[i] < 0)
+			continue;
+
+		size_t hash = hashOf(oldKeys[i]);
+		size_t slot = findInsertSlot(hash);
+		setControl(slot, controlByte(hash));
+		relocate(keys[slot], oldKeys[i], std::is_trivially_copyable<K>());
+		relocate(values[slot], oldValues[i], std::is_trivially_copyable<V>());
+	}
+}
+
+template<class K, class V, class Hash, class Equal>
+inline void FlatHashMap<K, V, Hash, Equal>::copy(const FlatHashMap& other)
+{
+	size = 0;
+	if (capacity != other.capacity) {
+		capacity = 0;
+		rehash(other.capacity);
+	}
+
+	for (size_t i = 0; i < capacity + GROUP_WIDTH - 1 && capacity > 0; ++i)
+		control[i] = other.control[i];
+
+	for (size_t i = 0; i < capacity; ++i) {
+		if (control[i] >= 0) {
+			keys[i] = other.keys[i];
+			values[i] = other.values[i];
+		}
+	}
+
+	size = other.size;
+	growthLeft = other.growthLeft;
+}
+
+template<class K, class V, class Hash, class Equal>
+template<class T>
+inline void FlatHashMap<K, V, Hash, Equal>::relocate(T& target, const T& source, std::true_type)
+{
+	std::memcpy(&target, &source, sizeof(T));
+}
+
+template<class K, class V, class Hash, class Equal>
+template<class T>
+inline void FlatHashMap<K, V, Hash, Equal>::relocate(T& target, const T& source, std::false_type)
+{
+	target = source;
+}
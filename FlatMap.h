@@ -0,0 +1,123 @@
+#pragma once
+#include <functional>
+#include <stdexcept>
+#include "DynamicArray.h"
+#include "Search.h"
+
+/**
+* \brief Ordered map stored in sorted dynamic arrays
+*
+* The keys and the values are kept in two separate arrays, sorted by key, so the binary search
+* reads only keys and touches fewer cache lines. Many entries should be inserted or erased with
+* the batch overloads, which sort the batch and merge it with the map in a single pass.
+*/
+template <class K, class V, class Compare = std::less<K>>
+class FlatMap
+{
+public:
+
+	//! Value returned by find() when the key is missing
+	static constexpr size_t npos = (size_t)-1;
+
+	//! Default constructor
+	FlatMap();
+
+	/**
+	* \brief Access a value by key
+	*
+	* If the key is missing, it is inserted with a default constructed value
+	*/
+	V& operator[](const K& key);
+
+	/**
+	* \brief Access a value by key
+	*
+	* If the key is missing, throws an out_of_range exception
+	*/
+	const V& at(const K& key) const;
+
+	/**
+	* \brief Access a value by key
+	*
+	* If the key is missing, throws an out_of_range exception
+	*/
+	V& at(const K& key);
+
+	/**
+	* \brief Add an entry
+	*
+	* \return True if the entry was added
+	* \return False if the key was already in the map. Its value is not changed
+	*/
+	bool insert(const K& key, const V& value);
+
+	/**
+	* \brief Add many entries
+	*
+	* The entries are sorted once and merged with the map in a single pass.
+	* Keys which are already in the map keep their values. For repeated keys in the batch the first entry is used.
+	* If the arrays have different sizes, throws an invalid_argument exception
+	* \return The number of entries which were added
+	*/
+	size_t insert(const DynamicArray<K>& batchKeys, const DynamicArray<V>& batchValues);
+
+	/**
+	* \brief Remove an entry
+	*
+	* \return True if the entry was removed
+	* \return False if the key was not in the map
+	*/
+	bool erase(const K& key);
+
+	/**
+	* \brief Remove many entries
+	*
+	* The batch is sorted and the map is compacted in a single pass.
+	* \return The number of entries which were removed
+	*/
+	size_t erase(const DynamicArray<K>& batch);
+
+	//! Position of the first key not less than the given one
+	size_t lower_bound(const K& key) const;
+	//! Position of the key, npos if it is missing
+	size_t find(const K& key) const;
+	//! Check if the key is in the map
+	bool contains(const K& key) const;
+
+	//! Return the key at the given position in the order
+	const K& getKey(size_t position) const;
+	//! Return the value at the given position in the order
+	const V& getValue(size_t position) const;
+	//! Return the value at the given position in the order
+	V& getValue(size_t position);
+
+	//! Return the sorted keys
+	const DynamicArray<K>& getKeys() const;
+	//! Return the values in the order of their keys
+	const DynamicArray<V>& getValues() const;
+
+	/**
+	* \brief Check if the map is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+
+private:
+
+	//! Inserts an entry at the given position, shifting the following ones
+	void insertAt(size_t position, const K& key, const V& value);
+
+
+	// Class members:
+
+	DynamicArray<K> keys;
+	DynamicArray<V> values; //!< values[i] belongs to keys[i]
+	Compare less;
+};
+
+#include "FlatMap.ipp"
@@ -0,0 +1,216 @@
+#include "FlatMap.h"
+#include <algorithm>
+
+template<class K, class V, class Compare>
+inline FlatMap<K, V, Compare>::FlatMap() : keys(), values(), less()
+{
+}
+
+template<class K, class V, class Compare>
+inline V& FlatMap<K, V, Compare>::operator[](const K& key)
+{
+	size_t position = lower_bound(key);
+	if (position == keys.getSize() || less(key, keys[position]))
+		insertAt(position, key, V());
+
+	return values[position];
+}
+
+template<class K, class V, class Compare>
+inline const V& FlatMap<K, V, Compare>::at(const K& key) const
+{
+	size_t position = find(key);
+	if (position == npos)
+		throw std::out_of_range("Key not found\n");
+
+	return values[position];
+}
+
+template<class K, class V, class Compare>
+inline V& FlatMap<K, V, Compare>::at(const K& key)
+{
+	return const_cast<V&>(const_cast<const FlatMap&>(*this).at(key));
+}
+
+template<class K, class V, class Compare>
+inline bool FlatMap<K, V, Compare>::insert(const K& key, const V& value)
+{
+	size_t position = lower_bound(key);
+	if (position < keys.getSize() && !less(key, keys[position]))
+		return false;
+
+	insertAt(position, key, value);
+	return true;
+}
+
+template<class K, class V, class Compare>
+inline size_t FlatMap<K, V, Compare>::insert(const DynamicArray<K>& batchKeys, const DynamicArray<V>& batchValues)
+{
+	if (batchKeys.getSize() != batchValues.getSize())
+		throw std::invalid_argument("Keys and values have different sizes\n");
+
+	// Sort positions in the batch, so the keys and the values are moved only once, during the merge
+	DynamicArray<size_t> order(batchKeys.getSize());
+	for (size_t i = 0; i < batchKeys.getSize(); ++i)
+		order.push_back(i);
+
+	const Compare& compare = less;
+	std::stable_sort(order.getData(), order.getData() + order.getSize(),
+		[&](size_t a, size_t b) { return compare(batchKeys[a], batchKeys[b]); });
+
+	size_t total = keys.getSize() + batchKeys.getSize();
+	DynamicArray<K> mergedKeys(total);
+	DynamicArray<V> mergedValues(total);
+	size_t i = 0;
+	size_t j = 0;
+	size_t added = 0;
+
+	while (i < keys.getSize() || j < order.getSize()) {
+		if (j == order.getSize() || (i < keys.getSize() && less(keys[i], batchKeys[order[j]]))) {
+			mergedKeys.push_back(keys[i]);
+			mergedValues.push_back(values[i]);
+			++i;
+		}
+		else if (i < keys.getSize() && !less(batchKeys[order[j]], keys[i])) {
+			// Already in the map
+			++j;
+		}
+		else if (!mergedKeys.empty() && !less(mergedKeys.back(), batchKeys[order[j]])) {
+			// Repeated in the batch, the first one was already taken
+			++j;
+		}
+		else {
+			mergedKeys.push_back(batchKeys[order[j]]);
+			mergedValues.push_back(batchValues[order[j]]);
+			++j;
+			++added;
+		}
+	}
+
+	keys = mergedKeys;
+	values = mergedValues;
+	return added;
+}
+
+template<class K, class V, class Compare>
+inline bool FlatMap<K, V, Compare>::erase(const K& key)
+{
+	size_t position = find(key);
+	if (position == npos)
+		return false;
+
+	for (size_t i = position; i + 1 < keys.getSize(); ++i) {
+		keys[i] = keys[i + 1];
+		values[i] = values[i + 1];
+	}
+	keys.pop_back();
+	values.pop_back();
+
+	return true;
+}
+
+template<class K, class V, class Compare>
+inline size_t FlatMap<K, V, Compare>::erase(const DynamicArray<K>& batch)
+{
+	DynamicArray<K> sorted(batch);
+	std::sort(sorted.getData(), sorted.getData() + sorted.getSize(), less);
+
+	size_t kept = 0;
+	size_t j = 0;
+
+	for (size_t i = 0; i < keys.getSize(); ++i) {
+		while (j < sorted.getSize() && less(sorted[j], keys[i]))
+			++j;
+
+		bool erased = j < sorted.getSize() && !less(keys[i], sorted[j]);
+		if (!erased) {
+			keys[kept] = keys[i];
+			values[kept] = values[i];
+			++kept;
+		}
+	}
+
+	size_t removed = keys.getSize() - kept;
+	keys.resize(kept);
+	values.resize(kept);
+	return removed;
+}
+
+template<class K, class V, class Compare>
+inline size_t FlatMap<K, V, Compare>::lower_bound(const K& key) const
+{
+	return branchlessLowerBound(keys.getData(), keys.getSize(), key, less);
+}
+
+template<class K, class V, class Compare>
+inline size_t FlatMap<K, V, Compare>::find(const K& key) const
+{
+	size_t position = lower_bound(key);
+	if (position < keys.getSize() && !less(key, keys[position]))
+		return position;
+
+	return npos;
+}
+
+template<class K, class V, class Compare>
+inline bool FlatMap<K, V, Compare>::contains(const K& key) const
+{
+	return find(key) != npos;
+}
+
+template<class K, class V, class Compare>
+inline const K& FlatMap<K, V, Compare>::getKey(size_t position) const
+{
+	return keys[position];
+}
+
+template<class K, class V, class Compare>
+inline const V& FlatMap<K, V, Compare>::getValue(size_t position) const
+{
+	return values[position];
+}
+
+template<class K, class V, class Compare>
+inline V& FlatMap<K, V, Compare>::getValue(size_t position)
+{
+	return values[position];
+}
+
+template<class K, class V, class Compare>
+inline const DynamicArray<K>& FlatMap<K, V, Compare>::getKeys() const
+{
+	return keys;
+}
+
+template<class K, class V, class Compare>
+inline const DynamicArray<V>& FlatMap<K, V, Compare>::getValues() const
+{
+	return values;
+}
+
+template<class K, class V, class Compare>
+inline bool FlatMap<K, V, Compare>::empty() const
+{
+	return keys.empty();
+}
+
+template<class K, class V, class Compare>
+inline size_t FlatMap<K, V, Compare>::getSize() const
+{
+	return keys.getSize();
+}
+
+template<class K, class V, class Compare>
+inline void FlatMap<K, V, Compare>::insertAt(size_t position, const K& key, const V& value)
+{
+	keys.push_back(key);
+	values.push_back(value);
+
+	for (size_t i = keys.getSize() - 1; i > position; --i) {
+		keys[i] = keys[i - 1];
+		values[i] = values[i - 1];
+	}
+
+	keys[position] = key;
+	values[position] = value;
+}
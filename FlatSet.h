@@ -0,0 +1,94 @@
+#pragma once
+#include <functional>
+#include "DynamicArray.h"
+#include "Search.h"
+
+/**
+* \brief Ordered set stored in a sorted dynamic array
+*
+* The keys are kept sorted and contiguous, so lookups are cache friendly binary searches.
+* Single inserts and erases shift the following keys. Many keys should be inserted or erased
+* with the batch overloads, which sort the batch and merge it with the set in a single pass.
+*/
+template <class K, class Compare = std::less<K>>
+class FlatSet
+{
+public:
+
+	//! Value returned by find() when the key is missing
+	static constexpr size_t npos = (size_t)-1;
+
+	//! Default constructor
+	FlatSet();
+	//! Constructs the object by the keys of a given initializer list
+	FlatSet(const std::initializer_list<K>& lst);
+
+	/**
+	* \brief Access a key by its position in the order
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const K& operator[](size_t position) const;
+
+	/**
+	* \brief Add a key
+	*
+	* \return True if the key was added
+	* \return False if it was already in the set
+	*/
+	bool insert(const K& key);
+
+	/**
+	* \brief Add many keys
+	*
+	* The keys are appended to a buffer, sorted once and merged with the set in a single pass.
+	* \return The number of keys which were added
+	*/
+	size_t insert(const DynamicArray<K>& batch);
+
+	/**
+	* \brief Remove a key
+	*
+	* \return True if the key was removed
+	* \return False if it was not in the set
+	*/
+	bool erase(const K& key);
+
+	/**
+	* \brief Remove many keys
+	*
+	* The batch is sorted and the set is compacted in a single pass.
+	* \return The number of keys which were removed
+	*/
+	size_t erase(const DynamicArray<K>& batch);
+
+	//! Position of the first key not less than the given one
+	size_t lower_bound(const K& key) const;
+	//! Position of the first key greater than the given one
+	size_t upper_bound(const K& key) const;
+	//! Position of the key, npos if it is missing
+	size_t find(const K& key) const;
+	//! Check if the key is in the set
+	bool contains(const K& key) const;
+
+	//! Return the sorted keys
+	const DynamicArray<K>& getKeys() const;
+
+	/**
+	* \brief Check if the set is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+
+private:
+
+	DynamicArray<K> keys;
+	Compare less;
+};
+
+#include "FlatSet.ipp"
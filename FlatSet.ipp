@@ -0,0 +1,152 @@
+#include "FlatSet.h"
+#include <algorithm>
+
+template<class K, class Compare>
+inline FlatSet<K, Compare>::FlatSet() : keys(), less()
+{
+}
+
+template<class K, class Compare>
+inline FlatSet<K, Compare>::FlatSet(const std::initializer_list<K>& lst) : FlatSet()
+{
+	insert(DynamicArray<K>(lst));
+}
+
+template<class K, class Compare>
+inline const K& FlatSet<K, Compare>::operator[](size_t position) const
+{
+	return keys[position];
+}
+
+template<class K, class Compare>
+inline bool FlatSet<K, Compare>::insert(const K& key)
+{
+	size_t position = lower_bound(key);
+	if (position < keys.getSize() && !less(key, keys[position]))
+		return false;
+
+	keys.push_back(key);
+	for (size_t i = keys.getSize() - 1; i > position; --i)
+		keys[i] = keys[i - 1];
+	keys[position] = key;
+
+	return true;
+}
+
+template<class K, class Compare>
+inline size_t FlatSet<K, Compare>::insert(const DynamicArray<K>& batch)
+{
+	DynamicArray<K> sorted(batch);
+	std::sort(sorted.getData(), sorted.getData() + sorted.getSize(), less);
+
+	DynamicArray<K> merged(keys.getSize() + sorted.getSize());
+	size_t i = 0;
+	size_t j = 0;
+	size_t added = 0;
+
+	while (i < keys.getSize() || j < sorted.getSize()) {
+		if (j == sorted.getSize() || (i < keys.getSize() && less(keys[i], sorted[j]))) {
+			merged.push_back(keys[i++]);
+		}
+		else if (i < keys.getSize() && !less(sorted[j], keys[i])) {
+			// Already in the set
+			++j;
+		}
+		else if (!merged.empty() && !less(merged.back(), sorted[j])) {
+			// Duplicate inside the batch
+			++j;
+		}
+		else {
+			merged.push_back(sorted[j++]);
+			++added;
+		}
+	}
+
+	keys = merged;
+	return added;
+}
+
+template<class K, class Compare>
+inline bool FlatSet<K, Compare>::erase(const K& key)
+{
+	size_t position = find(key);
+	if (position == npos)
+		return false;
+
+	for (size_t i = position; i + 1 < keys.getSize(); ++i)
+		keys[i] = keys[i + 1];
+	keys.pop_back();
+
+	return true;
+}
+
+template<class K, class Compare>
+inline size_t FlatSet<K, Compare>::erase(const DynamicArray<K>& batch)
+{
+	DynamicArray<K> sorted(batch);
+	std::sort(sorted.getData(), sorted.getData() + sorted.getSize(), less);
+
+	size_t kept = 0;
+	size_t j = 0;
+
+	for (size_t i = 0; i < keys.getSize(); ++i) {
+		while (j < sorted.getSize() && less(sorted[j], keys[i]))
+			++j;
+
+		bool erased = j < sorted.getSize() && !less(keys[i], sorted[j]);
+		if (!erased)
+			keys[kept++] = keys[i];
+	}
+
+	size_t removed = keys.getSize() - kept;
+	keys.resize(kept);
+	return removed;
+}
+
+template<class K, class Compare>
+inline size_t FlatSet<K, Compare>::lower_bound(const K& key) const
+{
+	return branchlessLowerBound(keys.getData(), keys.getSize(), key, less);
+}
+
+template<class K, class Compare>
+inline size_t FlatSet<K, Compare>::upper_bound(const K& key) const
+{
+	const Compare& compare = less;
+	return branchlessLowerBound(keys.getData(), keys.getSize(), key,
+		[&compare](const K& element, const K& value) { return !compare(value, element); });
+}
+
+template<class K, class Compare>
+inline size_t FlatSet<K, Compare>::find(const K& key) const
+{
+	size_t position = lower_bound(key);
+	if (position < keys.getSize() && !less(key, keys[position]))
+		return position;
+
+	return npos;
+}
+
+template<class K, class Compare>
+inline bool FlatSet<K, Compare>::contains(const K& key) const
+{
+	return find(key) != npos;
+}
+
+template<class K, class Compare>
+inline const DynamicArray<K>& FlatSet<K, Compare>::getKeys() const
+{
+	return keys;
+}
+
+template<class K, class Compare>
+inline bool FlatSet<K, Compare>::empty() const
+{
+	return keys.empty();
+}
+
+template<class K, class Compare>
+inline size_t FlatSet<K, Compare>::getSize() const
+{
+	return keys.getSize();
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include "Prefetch.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/*
+* Indexed loads and stores over plain buffers.
+*
+* A loop like out[i] = source[indices[i]] over random indices waits for one cache miss at a time.
+* These kernels prefetch the element needed distance iterations ahead, so that many misses are in
+* flight at once. Where the compiler targets AVX2, 4 and 8 byte elements are loaded with gather
+* instructions, four at a time.
+*/
+
+//! Default number of iterations between prefetching an element and using it
+static constexpr size_t GATHER_PREFETCH_DISTANCE = 16;
+
+//! Number of indices sorted together by the sorted gather and scatter
+static constexpr size_t GATHER_SORT_BATCH = (size_t)1 << 14;
+
+//! Vector gather width for T: its size if it can be gathered as a 32 or 64-bit integer, otherwise 0
+template <class T>
+using GatherWidth = std::integral_constant<size_t,
+	std::is_trivially_copyable<T>::value && sizeof(size_t) == 8 && (sizeof(T) == 4 || sizeof(T) == 8) ? sizeof(T) : 0>;
+
+//! No vector path for this type
+template <class T, size_t Width>
+inline size_t gatherVector(const T*, const size_t*, size_t, T*, size_t, std::integral_constant<size_t, Width>)
+{
+	return 0;
+}
+
+#ifdef __AVX2__
+//! Gathers groups of four 32-bit elements and returns the number of elements done
+template <class T>
+inline size_t gatherVector(const T* source, const size_t* indices, size_t count, T* out, size_t distance, std::integral_constant<size_t, 4>)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		for (size_t k = i + distance; k < i + distance + 4 && k < count; ++k)
+			prefetch(source + indices[k]);
+
+		__m256i offsets = _mm256_loadu_si256((const __m256i*)(indices + i));
+		__m128i values = _mm256_i64gather_epi32((const int*)source, offsets, 4);
+		_mm_storeu_si128((__m128i*)(out + i), values);
+	}
+	return i;
+}
+
+//! Gathers groups of four 64-bit elements and returns the number of elements done
+template <class T>
+inline size_t gatherVector(const T* source, const size_t* indices, size_t count, T* out, size_t distance, std::integral_constant<size_t, 8>)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		for (size_t k = i + distance; k < i + distance + 4 && k < count; ++k)
+			prefetch(source + indices[k]);
+
+		__m256i offsets = _mm256_loadu_si256((const __m256i*)(indices + i));
+		__m256i values = _mm256_i64gather_epi64((const long long*)source, offsets, 8);
+		_mm256_storeu_si256((__m256i*)(out + i), values);
+	}
+	return i;
+}
+#endif
+
+/**
+* \brief out[i] = source[indices[i]] for i in [0, count)
+*
+* The element for iteration i + distance is prefetched in iteration i.
+*/
+template <class T>
+inline void gatherElements(const T* source, const size_t* indices, size_t count, T* out, size_t distance)
+{
+	size_t i = gatherVector(source, indices, count, out, distance, GatherWidth<T>());
+
+	for (; i < count; ++i) {
+		if (i + distance < count)
+			prefetch(source + indices[i + distance]);
+		out[i] = source[indices[i]];
+	}
+}
+
+/**
+* \brief target[indices[i]] = values[i] for i in [0, count), in increasing order of i
+*
+* The element for iteration i + distance is prefetched in iteration i.
+*/
+template <class T>
+inline void scatterElements(T* target, const size_t* indices, size_t count, const T* values, size_t distance)
+{
+	for (size_t i = 0; i < count; ++i) {
+		if (i + distance < count)
+			prefetch(target + indices[i + distance]);
+		target[indices[i]] = values[i];
+	}
+}
+
+//! out[order[k]] = source[indices[order[k]]] for k in [0, count), with prefetching
+template <class T>
+inline void gatherInOrder(const T* source, const size_t* indices, const size_t* order, size_t count, T* out, size_t distance)
+{
+	for (size_t k = 0; k < count; ++k) {
+		if (k + distance < count)
+			prefetch(source + indices[order[k + distance]]);
+		out[order[k]] = source[indices[order[k]]];
+	}
+}
+
+//! target[indices[order[k]]] = values[order[k]] for k in [0, count), with prefetching
+template <class T>
+inline void scatterInOrder(T* target, const size_t* indices, const size_t* order, size_t count, const T* values, size_t distance)
+{
+	for (size_t k = 0; k < count; ++k) {
+		if (k + distance < count)
+			prefetch(target + indices[order[k + distance]]);
+		target[indices[order[k]]] = values[order[k]];
+	}
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+* \brief Storage of InplaceArray
+*
+* Raw bytes for N elements and the number of constructed ones. For trivially copyable types the
+* copy operations and the destructor are left to the compiler, so the array is trivially copyable
+* as well. Other types get copies and a destructor which touch only the constructed elements.
+*/
+template <class T, size_t N, bool Trivial = std::is_trivially_copyable<T>::value>
+class InplaceStorage
+{
+protected:
+	InplaceStorage() : size(0) {}
+
+	T* elements() { return reinterpret_cast<T*>(bytes); }
+	const T* elements() const { return reinterpret_cast<const T*>(bytes); }
+
+	alignas(T) unsigned char bytes[N * sizeof(T)];
+	size_t size;
+};
+
+template <class T, size_t N>
+class InplaceStorage<T, N, false>
+{
+protected:
+	InplaceStorage() : size(0) {}
+
+	InplaceStorage(const InplaceStorage& other) : size(0) {
+		for (; size < other.size; ++size)
+			new (elements() + size) T(other.elements()[size]);
+	}
+
+	InplaceStorage& operator=(const InplaceStorage& other) {
+		if (this != &other) {
+			destroy();
+			for (; size < other.size; ++size)
+				new (elements() + size) T(other.elements()[size]);
+		}
+
+		return *this;
+	}
+
+	~InplaceStorage() {
+		destroy();
+	}
+
+	T* elements() { return reinterpret_cast<T*>(bytes); }
+	const T* elements() const { return reinterpret_cast<const T*>(bytes); }
+
+	//! Destroys all elements
+	void destroy() {
+		for (; size > 0; --size)
+			elements()[size - 1].~T();
+	}
+
+	alignas(T) unsigned char bytes[N * sizeof(T)];
+	size_t size;
+};
+
+/**
+* \brief Array with a fixed capacity of N elements, stored inside the object
+*
+* Has the interface of DynamicArray but never allocates, so it can live on the stack or inside
+* other objects. Only the first size elements are constructed. Adding elements beyond the
+* capacity throws a length_error exception. If T is trivially copyable, so is the array.
+*/
+template <class T, size_t N>
+class InplaceArray : private InplaceStorage<T, N>
+{
+	static_assert(N > 0, "Capacity must be positive");
+
+public:
+
+	//! Default constructor
+	InplaceArray() = default;
+	//! Constructs the object by the elements of a given initializer list
+	InplaceArray(const std::initializer_list<T>& lst);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* By given position returns a const reference to the element at that position
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const T& operator[](size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* By given position returns a reference to the element at that position
+	* If the position is invalid, the behaviour is undefined
+	*/
+	T& operator[](size_t position);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* By given position returns a const reference to the element at that position
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	const T& at(size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* By given position returns a reference to the element at that position
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	T& at(size_t position);
+
+	//! Access the first element. If the array is empty, the behaviour is undefined
+	const T& front() const;
+	//! Access the first element. If the array is empty, the behaviour is undefined
+	T& front();
+	//! Access the last element. If the array is empty, the behaviour is undefined
+	const T& back() const;
+	//! Access the last element. If the array is empty, the behaviour is undefined
+	T& back();
+
+	/**
+	* \brief Add an element
+	*
+	* Constructs a copy of the element at position size.
+	* If the array is full, throws a length_error exception
+	*/
+	void push_back(const T& element);
+
+	/**
+	* \brief Remove an element
+	*
+	* Destroys the element at the last position.
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_back();
+
+	/**
+	* \brief Resize the array
+	*
+	* New elements are default initialized, removed elements are destroyed.
+	* If the wanted size is more than N, throws a length_error exception
+	*/
+	void resize(size_t newSize);
+
+	/**
+	* \brief Resize the array
+	*
+	* New elements are copies of value, removed elements are destroyed.
+	* If the wanted size is more than N, throws a length_error exception
+	*/
+	void resize(size_t newSize, const T& value);
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return pointer to the first element
+	const T* getData() const;
+	//! Return pointer to the first element
+	T* getData();
+	//! Return size
+	size_t getSize() const;
+	//! Return capacity, which is always N
+	size_t getCapacity() const;
+
+private:
+
+	//! Constructs elements from size up to newSize
+	template <class Construct>
+	void grow(size_t newSize, Construct construct);
+	//! Destroys elements from newSize up to size
+	void shrink(size_t newSize);
+};
+
+#include "InplaceArray.ipp"
@@ -0,0 +1,147 @@
+#include "InplaceArray.h"
+
+template<class T, size_t N>
+inline InplaceArray<T, N>::InplaceArray(const std::initializer_list<T>& lst)
+{
+	if (lst.size() > N)
+		throw std::length_error("Too many elements\n");
+
+	for (const T& element : lst)
+		push_back(element);
+}
+
+template<class T, size_t N>
+inline const T& InplaceArray<T, N>::operator[](size_t position) const
+{
+	return this->elements()[position];
+}
+
+template<class T, size_t N>
+inline T& InplaceArray<T, N>::operator[](size_t position)
+{
+	return const_cast<T&>(const_cast<const InplaceArray&>(*this)[position]);
+}
+
+template<class T, size_t N>
+inline const T& InplaceArray<T, N>::at(size_t position) const
+{
+	if (this->size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return this->elements()[position];
+}
+
+template<class T, size_t N>
+inline T& InplaceArray<T, N>::at(size_t position)
+{
+	return const_cast<T&>(const_cast<const InplaceArray&>(*this).at(position));
+}
+
+template<class T, size_t N>
+inline const T& InplaceArray<T, N>::front() const
+{
+	return this->elements()[0];
+}
+
+template<class T, size_t N>
+inline T& InplaceArray<T, N>::front()
+{
+	return const_cast<T&>(const_cast<const InplaceArray&>(*this).front());
+}
+
+template<class T, size_t N>
+inline const T& InplaceArray<T, N>::back() const
+{
+	return this->elements()[this->size - 1];
+}
+
+template<class T, size_t N>
+inline T& InplaceArray<T, N>::back()
+{
+	return const_cast<T&>(const_cast<const InplaceArray&>(*this).back());
+}
+
+template<class T, size_t N>
+inline void InplaceArray<T, N>::push_back(const T& element)
+{
+	if (this->size == N)
+		throw std::length_error("Inplace array is full\n");
+
+	new (this->elements() + this->size) T(element);
+	++this->size;
+}
+
+template<class T, size_t N>
+inline void InplaceArray<T, N>::pop_back()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+
+	shrink(this->size - 1);
+}
+
+template<class T, size_t N>
+inline void InplaceArray<T, N>::resize(size_t newSize)
+{
+	if (newSize > N)
+		throw std::length_error("Inplace array is full\n");
+
+	shrink(newSize);
+	grow(newSize, [](T* place) { new (place) T; });
+}
+
+template<class T, size_t N>
+inline void InplaceArray<T, N>::resize(size_t newSize, const T& value)
+{
+	if (newSize > N)
+		throw std::length_error("Inplace array is full\n");
+
+	shrink(newSize);
+	grow(newSize, [&value](T* place) { new (place) T(value); });
+}
+
+template<class T, size_t N>
+inline bool InplaceArray<T, N>::empty() const
+{
+	return this->size == 0;
+}
+
+template<class T, size_t N>
+inline const T* InplaceArray<T, N>::getData() const
+{
+	return this->elements();
+}
+
+template<class T, size_t N>
+inline T* InplaceArray<T, N>::getData()
+{
+	return this->elements();
+}
+
+template<class T, size_t N>
+inline size_t InplaceArray<T, N>::getSize() const
+{
+	return this->size;
+}
+
+template<class T, size_t N>
+inline size_t InplaceArray<T, N>::getCapacity() const
+{
+	return N;
+}
+
+template<class T, size_t N>
+template<class Construct>
+inline void InplaceArray<T, N>::grow(size_t newSize, Construct construct)
+{
+	// The size is increased after each element, so a throwing constructor leaves a valid array
+	for (; this->size < newSize; ++this->size)
+		construct(this->elements() + this->size);
+}
+
+template<class T, size_t N>
+inline void InplaceArray<T, N>::shrink(size_t newSize)
+{
+	for (; this->size > newSize; --this->size)
+		this->elements()[this->size - 1].~T();
+}
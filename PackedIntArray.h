@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "Bits.h"
+#include "Container.h"
+#include "DynamicArray.h"
+
+/**
+* \brief Dynamic array of unsigned integers packed with a fixed number of bits each
+*
+* Every value takes exactly width bits and values may cross word boundaries.
+* The width is chosen at runtime and grows automatically when a value that doesn't fit is stored.
+*/
+class PackedIntArray
+{
+private:
+	static constexpr float RESIZE_FACTOR = 1.6f;
+	static constexpr unsigned WORD_BITS = 64;
+
+public:
+
+	//! Constructs an empty array with the given bit width (1 to 64)
+	PackedIntArray(unsigned width = 1);
+	//! Copy constructor
+	PackedIntArray(const PackedIntArray& other);
+	//! Constructs the object by the elements of a given initializer list. The width fits the largest one
+	PackedIntArray(const std::initializer_list<uint64_t>& lst);
+
+	//! Operator =
+	PackedIntArray& operator=(const PackedIntArray& other);
+
+	/**
+	* \brief Read a value
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	uint64_t get(size_t position) const;
+
+	/**
+	* \brief Read a value
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	uint64_t at(size_t position) const;
+
+	/**
+	* \brief Change a value
+	*
+	* If the value doesn't fit in the current width, the array is widened first.
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	void set(size_t position, uint64_t value);
+
+	/**
+	* \brief Add a value
+	*
+	* Adds a value on the back of the array.
+	* If the value doesn't fit in the current width, the array is widened first.
+	*/
+	void push_back(uint64_t value);
+
+	/**
+	* \brief Remove a value
+	*
+	* Removes the value at the last position.
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_back();
+
+	//! Reserve space for at least the given number of values with the current width
+	void reserve(size_t newCapacity);
+
+	/**
+	* \brief Increase the bit width
+	*
+	* Repacks all values with the given width. Does nothing if it is not greater than the current one.
+	*/
+	void widen(unsigned newWidth);
+
+	/**
+	* \brief Decode a block of values
+	*
+	* Appends the values in the range [from, from + count) to out.
+	* The words are read sequentially and unpacked from a bit buffer, without a division per value.
+	* If the range is invalid, throws an out_of_range exception
+	*/
+	template <class U>
+	void decode(size_t from, size_t count, DynamicArray<U>& out) const;
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+	//! Return capacity with the current width
+	size_t getCapacity() const;
+	//! Return the number of bits per value
+	unsigned getWidth() const;
+
+	//! Number of bits needed to store the value
+	static unsigned bitsNeeded(uint64_t value);
+
+private:
+
+	//! Mask with the lowest width bits set
+	uint64_t valueMask() const;
+	//! Writes a value which fits in the width
+	void write(size_t position, uint64_t value);
+	//! Number of words needed for the given number of values
+	size_t wordCount(size_t values) const;
+	//! Copies the data of other object
+	void copy(const PackedIntArray& other);
+
+
+	// Class members:
+
+	Container<uint64_t> words;
+	size_t size;    //!< Number of values stored in the array
+	unsigned width; //!< Number of bits per value
+};
+
+#include "PackedIntArray.ipp"
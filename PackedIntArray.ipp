@@ -0,0 +1,211 @@
+#include "PackedIntArray.h"
+
+inline PackedIntArray::PackedIntArray(unsigned width) : words(), size(0), width(width)
+{
+	if (width == 0 || width > WORD_BITS)
+		throw std::invalid_argument("Width must be between 1 and 64\n");
+}
+
+inline PackedIntArray::PackedIntArray(const PackedIntArray& other) : PackedIntArray(other.width)
+{
+	copy(other);
+}
+
+inline PackedIntArray::PackedIntArray(const std::initializer_list<uint64_t>& lst) : PackedIntArray()
+{
+	uint64_t largest = 0;
+	for (uint64_t value : lst)
+		largest |= value;
+
+	width = bitsNeeded(largest);
+	reserve(lst.size());
+	for (uint64_t value : lst)
+		push_back(value);
+}
+
+inline PackedIntArray& PackedIntArray::operator=(const PackedIntArray& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+inline uint64_t PackedIntArray::get(size_t position) const
+{
+	size_t bit = position * width;
+	size_t index = bit / WORD_BITS;
+	unsigned offset = bit % WORD_BITS;
+
+	uint64_t value = words[index] >> offset;
+	if (offset + width > WORD_BITS)
+		value |= words[index + 1] << (WORD_BITS - offset);
+
+	return value & valueMask();
+}
+
+inline uint64_t PackedIntArray::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return get(position);
+}
+
+inline void PackedIntArray::set(size_t position, uint64_t value)
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	widen(bitsNeeded(value));
+	write(position, value);
+}
+
+inline void PackedIntArray::push_back(uint64_t value)
+{
+	widen(bitsNeeded(value));
+
+	if (size == getCapacity()) {
+
+		size_t newCapacity = (size_t)(getCapacity() * RESIZE_FACTOR);
+		if (newCapacity <= size)
+			newCapacity = size + 1;
+
+		reserve(newCapacity);
+	}
+
+	write(size, value);
+	++size;
+}
+
+inline void PackedIntArray::pop_back()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	--size;
+}
+
+inline void PackedIntArray::reserve(size_t newCapacity)
+{
+	words.reserve(wordCount(size), wordCount(newCapacity));
+}
+
+inline void PackedIntArray::widen(unsigned newWidth)
+{
+	if (newWidth <= width)
+		return;
+
+	PackedIntArray temp(newWidth);
+	temp.reserve(size > getCapacity() ? size : getCapacity());
+	for (size_t i = 0; i < size; ++i)
+		temp.write(i, get(i));
+	temp.size = size;
+
+	words.swap(temp.words);
+	width = newWidth;
+}
+
+template<class U>
+inline void PackedIntArray::decode(size_t from, size_t count, DynamicArray<U>& out) const
+{
+	if (from > size || count > size - from)
+		throw std::out_of_range("Out of range\n");
+
+	out.reserve(out.getSize() + count);
+	if (count == 0)
+		return;
+
+	const uint64_t mask = valueMask();
+	size_t bit = from * width;
+	size_t index = bit / WORD_BITS;
+	unsigned offset = bit % WORD_BITS;
+
+	// buffer holds the not yet consumed bits of the current word starting from bit 0
+	uint64_t buffer = words[index] >> offset;
+	unsigned available = WORD_BITS - offset;
+
+	for (size_t i = 0; i < count; ++i) {
+		uint64_t value = buffer;
+
+		if (available >= width) {
+			buffer = width == WORD_BITS ? 0 : buffer >> width;
+			available -= width;
+		}
+		else {
+			// The value continues in the next word
+			uint64_t next = words[++index];
+			value |= next << available;
+			unsigned used = width - available;
+			buffer = used == WORD_BITS ? 0 : next >> used;
+			available = WORD_BITS - used;
+		}
+
+		out.push_back((U)(value & mask));
+
+		if (available == 0 && i + 1 < count) {
+			buffer = words[++index];
+			available = WORD_BITS;
+		}
+	}
+}
+
+inline bool PackedIntArray::empty() const
+{
+	return size == 0;
+}
+
+inline size_t PackedIntArray::getSize() const
+{
+	return size;
+}
+
+inline size_t PackedIntArray::getCapacity() const
+{
+	return words.getCap() * WORD_BITS / width;
+}
+
+inline unsigned PackedIntArray::getWidth() const
+{
+	return width;
+}
+
+inline unsigned PackedIntArray::bitsNeeded(uint64_t value)
+{
+	return value == 0 ? 1 : highestBit(value) + 1;
+}
+
+inline uint64_t PackedIntArray::valueMask() const
+{
+	return width == WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+}
+
+inline void PackedIntArray::write(size_t position, uint64_t value)
+{
+	size_t bit = position * width;
+	size_t index = bit / WORD_BITS;
+	unsigned offset = bit % WORD_BITS;
+	uint64_t mask = valueMask();
+
+	words[index] = (words[index] & ~(mask << offset)) | (value << offset);
+	if (offset + width > WORD_BITS) {
+		unsigned shift = WORD_BITS - offset;
+		words[index + 1] = (words[index + 1] & ~(mask >> shift)) | (value >> shift);
+	}
+}
+
+inline size_t PackedIntArray::wordCount(size_t values) const
+{
+	return (values * width + WORD_BITS - 1) / WORD_BITS;
+}
+
+inline void PackedIntArray::copy(const PackedIntArray& other)
+{
+	width = other.width;
+	size = 0;
+	reserve(other.size);
+	for (size_t i = 0; i < wordCount(other.size); ++i)
+		words[i] = other.words[i];
+
+	size = other.size;
+}
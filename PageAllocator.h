@@ -0,0 +1,204 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+* Allocation of large buffers directly from the operating system.
+*
+* Buffers of at least HUGE_PAGE_THRESHOLD bytes of arrays which asked for huge pages, or for a NUMA
+* placement, are aligned to HUGE_PAGE_SIZE and their size is rounded up to a multiple of it. With huge
+* pages the kernel can back them with 2 MB pages, so random access needs far fewer TLB entries. On
+* Linux such buffers are marked with madvise(MADV_HUGEPAGE). Compile with DYNAMIC_ARRAY_HUGETLB to
+* take pages from the reserved huge page pool first (MAP_HUGETLB, or MEM_LARGE_PAGES on Windows), and
+* with DYNAMIC_ARRAY_NO_HUGE_PAGES to turn the large allocation path off.
+*/
+
+//! Size of a huge page in bytes
+static constexpr size_t HUGE_PAGE_SIZE = (size_t)2 << 20;
+
+//! Largest supported buffer alignment, the size of a regular page
+static constexpr size_t MAX_ALIGNMENT = 4096;
+
+#ifdef DYNAMIC_ARRAY_HUGE_PAGE_THRESHOLD
+static constexpr size_t HUGE_PAGE_THRESHOLD = DYNAMIC_ARRAY_HUGE_PAGE_THRESHOLD;
+#else
+//! Buffers of at least that many bytes are allocated in huge pages when an array asks for them
+static constexpr size_t HUGE_PAGE_THRESHOLD = 2 * HUGE_PAGE_SIZE;
+#endif
+
+//! Placement of the pages of a large buffer on the NUMA nodes of the machine
+enum class Placement
+{
+	Local,       //!< Each page goes to the node of the thread which first writes to it. Buffers are filled by one thread
+	Interleaved, //!< Pages are spread round-robin over all nodes the process may use
+	Partitioned  //!< Buffers are filled by several threads, each writing one contiguous range, so each range lands on its thread's node
+};
+
+//! Check if a buffer of the given size is allocated by allocatePages()
+inline bool isLargeAllocation(size_t bytes)
+{
+#ifdef DYNAMIC_ARRAY_NO_HUGE_PAGES
+	(void)bytes;
+	return false;
+#else
+	return bytes >= HUGE_PAGE_THRESHOLD;
+#endif
+}
+
+//! Rounds a size up to a multiple of the huge page size
+inline size_t roundToHugePages(size_t bytes)
+{
+	return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+/**
+* \brief Allocates a buffer aligned to the given power of two
+*
+* For alignments above what new guarantees. Throws bad_alloc on failure.
+*/
+inline void* allocateAligned(size_t bytes, size_t alignment)
+{
+#if defined(_MSC_VER)
+	void* memory = _aligned_malloc(bytes, alignment);
+#elif defined(__unix__) || defined(__APPLE__)
+	void* memory = nullptr;
+	if (posix_memalign(&memory, alignment < sizeof(void*) ? sizeof(void*) : alignment, bytes) != 0)
+		memory = nullptr;
+#else
+	void* memory = std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+#endif
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+//! Releases a buffer returned by allocateAligned()
+inline void releaseAligned(void* memory)
+{
+#if defined(_MSC_VER)
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+/**
+* \brief Allocates a buffer aligned to HUGE_PAGE_SIZE
+*
+* The size must be a multiple of HUGE_PAGE_SIZE. If hugePages is false, the buffer is left to
+* regular pages. Throws bad_alloc on failure.
+*/
+inline void* allocatePages(size_t bytes, bool hugePages)
+{
+#if defined(_WIN32)
+#ifdef DYNAMIC_ARRAY_HUGETLB
+	size_t largePage = GetLargePageMinimum();
+	if (hugePages && largePage != 0 && bytes % largePage == 0) {
+		void* large = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (large)
+			return large;
+	}
+#endif
+	// Windows has no transparent huge pages. The reservation is at least 64 KB aligned
+	(void)hugePages;
+	void* memory = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+
+#elif defined(__unix__) || defined(__APPLE__)
+#if defined(DYNAMIC_ARRAY_HUGETLB) && defined(MAP_HUGETLB)
+	if (hugePages) {
+		void* huge = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (huge != MAP_FAILED)
+			return huge;
+	}
+#endif
+	// Map one huge page more than needed and unmap the parts before and after the aligned range
+	size_t mapped = bytes + HUGE_PAGE_SIZE;
+	void* memory = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED)
+		throw std::bad_alloc();
+
+	char* begin = (char*)memory;
+	char* aligned = (char*)(((size_t)begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+	if (aligned != begin)
+		munmap(begin, aligned - begin);
+	if (aligned + bytes != begin + mapped)
+		munmap(aligned + bytes, begin + mapped - (aligned + bytes));
+
+#ifdef MADV_HUGEPAGE
+	if (hugePages)
+		madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+	return aligned;
+
+#else
+	// No page level control, a plain allocation
+	(void)hugePages;
+	return ::operator new(bytes);
+#endif
+}
+
+//! Releases a buffer returned by allocatePages() of the given size
+inline void releasePages(void* memory, size_t bytes)
+{
+#if defined(_WIN32)
+	(void)bytes;
+	VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__unix__) || defined(__APPLE__)
+	munmap(memory, bytes);
+#else
+	(void)bytes;
+	::operator delete(memory);
+#endif
+}
+
+/**
+* \brief Applies a placement to pages of a buffer returned by allocatePages() before they are written
+*
+* Only Interleaved needs a memory policy, which is set with mbind() on Linux. The other placements
+* are decided by the threads which first write to the pages. The call is a hint: it does nothing
+* on other systems or when the kernel has no NUMA support.
+*/
+inline void placePages(void* memory, size_t bytes, Placement placement)
+{
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_get_mempolicy)
+	if (placement != Placement::Interleaved)
+		return;
+
+	// Values from <linux/mempolicy.h>, which is not installed everywhere
+	const int MPOL_INTERLEAVE_MODE = 3;
+	const unsigned long MPOL_F_MEMS_ALLOWED_FLAG = 1 << 2;
+	const unsigned long MAX_NODES = 1024;
+
+	unsigned long nodes[MAX_NODES / (8 * sizeof(unsigned long))] = {};
+	if (syscall(SYS_get_mempolicy, nullptr, nodes, MAX_NODES, nullptr, MPOL_F_MEMS_ALLOWED_FLAG) != 0)
+		return;
+
+	// The kernel reads one bit less than the given number of nodes
+	syscall(SYS_mbind, memory, bytes, MPOL_INTERLEAVE_MODE, nodes, MAX_NODES + 1, 0);
+#else
+	(void)memory;
+	(void)bytes;
+	(void)placement;
+#endif
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//! Number of hardware threads, at least 1
+inline unsigned hardwareThreads()
+{
+	unsigned threads = std::thread::hardware_concurrency();
+	return threads == 0 ? 1 : threads;
+}
+
+/**
+* \brief Splits [0, count) into one contiguous range per thread and calls f(begin, end) for each
+*
+* The first range is processed by the calling thread. For the same count and number of threads
+* thread i always gets the same range, which is what first-touch page placement relies on.
+* f must not throw.
+*/
+template <class F>
+inline void parallelFor(size_t count, unsigned threads, F f)
+{
+	if (threads > count)
+		threads = count == 0 ? 1 : (unsigned)count;
+
+	if (threads <= 1) {
+		f((size_t)0, count);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (unsigned i = 1; i < threads; ++i)
+		workers.emplace_back(f, count * i / threads, count * (i + 1) / threads);
+
+	f((size_t)0, count / threads);
+
+	for (std::thread& worker : workers)
+		worker.join();
+}
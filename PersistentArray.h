@@ -0,0 +1,220 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "DynamicArray.h"
+
+/**
+* \brief Immutable array with structural sharing between versions
+*
+* The elements are stored in a relaxed radix balanced tree (RRB-tree) with 32-wide nodes.
+* Every modifying operation returns a new version and leaves the current one untouched.
+* The versions share all nodes that were not changed, so a new version costs O(log32 n) memory instead of a full copy.
+*/
+template <class T>
+class PersistentArray
+{
+private:
+	static constexpr size_t BITS = 5;
+	static constexpr size_t BRANCHING = 1 << BITS;
+	static constexpr size_t MASK = BRANCHING - 1;
+	//! Number of extra nodes the concatenation is allowed to leave over the optimal count
+	static constexpr size_t MAX_EXTRAS = 2;
+
+	struct Node;
+	using NodePtr = std::shared_ptr<Node>;
+
+public:
+
+	class Transient;
+
+	//! Default constructor
+	PersistentArray();
+	//! Constructs the object by the elements of a dynamic array
+	PersistentArray(const DynamicArray<T>& arr);
+	//! Constructs the object by the elements of a given initializer list
+	PersistentArray(const std::initializer_list<T>& lst);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* By given position returns a const reference to the element at that position
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const T& operator[](size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* By given position returns a const reference to the element at that position
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	const T& at(size_t position) const;
+
+	/**
+	* \brief Add an element
+	*
+	* Returns a new version with the element added on the back.
+	* Only the nodes on the rightmost path are copied, so the operation is O(log32 n).
+	*/
+	PersistentArray push_back(const T& element) const;
+
+	/**
+	* \brief Change an element
+	*
+	* Returns a new version in which the element at the given position has the given value.
+	* Only the nodes on the path to the element are copied.
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	PersistentArray set(size_t position, const T& element) const;
+
+	/**
+	* \brief Take a part of the array
+	*
+	* Returns a new version with the elements in the range [from, to).
+	* The result shares all nodes that are not on the left or the right edge of the range.
+	* If the range is invalid, throws an out_of_range exception
+	*/
+	PersistentArray slice(size_t from, size_t to) const;
+
+	/**
+	* \brief Concatenate two arrays
+	*
+	* Returns a new version with the elements of other added after the elements of this array.
+	* Only the nodes on the right edge of this array and the left edge of other are rebuilt, so the operation is O(log32 n).
+	*/
+	PersistentArray concat(const PersistentArray& other) const;
+
+	/**
+	* \brief Start a batch of modifications
+	*
+	* Returns a mutable copy of the array which edits the nodes it has created in place.
+	* The current version is not affected.
+	*/
+	Transient transient() const;
+
+	//! Copies the elements into a dynamic array
+	DynamicArray<T> toDynamicArray() const;
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+
+private:
+
+	struct Node {
+		Node(size_t edit) : count(0), edit(edit) {}
+		virtual ~Node() = default;
+
+		size_t count; //!< Number of used slots
+		size_t edit;  //!< Id of the transient which owns the node. 0 if the node is immutable
+	};
+
+	struct Leaf : Node {
+		Leaf(size_t edit) : Node(edit) {}
+
+		T values[BRANCHING];
+	};
+
+	struct Inner : Node {
+		Inner(size_t edit) : Node(edit), relaxed(false) {}
+
+		NodePtr children[BRANCHING];
+		size_t sizes[BRANCHING]; //!< Cumulative number of elements in the children
+		bool relaxed;            //!< True if some child other than the last one is not full
+	};
+
+	PersistentArray(NodePtr root, size_t shift, size_t size);
+
+	//! Returns a new unique transient id
+	static size_t nextEdit();
+
+	static Leaf* asLeaf(const NodePtr& node);
+	static Inner* asInner(const NodePtr& node);
+	//! Number of elements stored under the node
+	static size_t nodeSize(const NodePtr& node, size_t shift);
+	//! Finds the child containing the element and makes position relative to it
+	static size_t findChild(const Inner* node, size_t shift, size_t& position);
+
+	//! Returns the node itself if the transient owns it, otherwise a copy owned by the transient
+	static NodePtr editable(const NodePtr& node, size_t shift, size_t edit);
+	//! Builds a chain of nodes down to a leaf holding only the element
+	static NodePtr newPath(size_t shift, const T& element, size_t edit);
+	//! Recomputes the sizes and the relaxed flag of an inner node
+	static void updateSizes(Inner* node, size_t shift);
+
+	static NodePtr appendRec(const NodePtr& node, size_t shift, const T& element, size_t edit);
+	static NodePtr setRec(const NodePtr& node, size_t shift, size_t position, const T& element, size_t edit);
+	static NodePtr takeRec(const NodePtr& node, size_t shift, size_t count);
+	static NodePtr dropRec(const NodePtr& node, size_t shift, size_t count);
+	static NodePtr concatRec(const NodePtr& left, size_t leftShift, const NodePtr& right, size_t rightShift);
+	static NodePtr rebalance(const NodePtr& left, const NodePtr& middle, const NodePtr& right, size_t shift);
+	static void collect(const NodePtr& node, size_t shift, DynamicArray<T>& result);
+
+	//! Removes the inner nodes with a single child from the top of the tree
+	void trimRoot();
+	void appendElement(const T& element, size_t edit);
+
+	const T& get(size_t position) const;
+
+
+	// Class members:
+
+	NodePtr root;
+	size_t shift; //!< Number of index bits handled below the root
+	size_t size;  //!< Number of elements stored in the array
+};
+
+/**
+* \brief Mutable version of a persistent array
+*
+* Used for bulk building and batched modifications.
+* The nodes created by the transient are changed in place, the shared ones are copied on the first change.
+* After persistent() is called the transient must not be used any more.
+* A transient cannot be copied, two copies would change the same nodes in place.
+*/
+template <class T>
+class PersistentArray<T>::Transient
+{
+public:
+
+	Transient(const Transient&) = delete;
+	Transient& operator=(const Transient&) = delete;
+	//! Takes over the nodes of other, which is left empty and can no longer change them
+	Transient(Transient&& other);
+	//! Takes over the nodes of other, which is left empty and can no longer change them
+	Transient& operator=(Transient&& other);
+
+	//! Access an element at given position. If the position is invalid, the behaviour is undefined
+	const T& operator[](size_t position) const;
+
+	//! Adds an element on the back of the array
+	void push_back(const T& element);
+
+	//! Changes the element at the given position. If the position is invalid, throws an out_of_range exception
+	void set(size_t position, const T& element);
+
+	//! Returns an immutable version with the current elements
+	PersistentArray persistent();
+
+	//! Return size
+	size_t getSize() const;
+
+private:
+	friend class PersistentArray<T>;
+
+	Transient(const PersistentArray& arr);
+
+	PersistentArray arr;
+	size_t edit; //!< Id marking the nodes the transient may change in place
+};
+
+#include "PersistentArray.ipp"
@@ -0,0 +1,616 @@
+#include "PersistentArray.h"
+
+template<class T>
+inline PersistentArray<T>::PersistentArray() : root(nullptr), shift(0), size(0)
+{
+}
+
+template<class T>
+inline PersistentArray<T>::PersistentArray(const DynamicArray<T>& arr) : PersistentArray()
+{
+	Transient builder = transient();
+	for (size_t i = 0; i < arr.getSize(); ++i)
+		builder.push_back(arr[i]);
+
+	*this = builder.persistent();
+}
+
+template<class T>
+inline PersistentArray<T>::PersistentArray(const std::initializer_list<T>& lst) : PersistentArray()
+{
+	Transient builder = transient();
+	for (const T& element : lst)
+		builder.push_back(element);
+
+	*this = builder.persistent();
+}
+
+template<class T>
+inline PersistentArray<T>::PersistentArray(NodePtr root, size_t shift, size_t size) : root(root), shift(shift), size(size)
+{
+}
+
+template<class T>
+inline const T& PersistentArray<T>::operator[](size_t position) const
+{
+	return get(position);
+}
+
+template<class T>
+inline const T& PersistentArray<T>::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return get(position);
+}
+
+template<class T>
+inline PersistentArray<T> PersistentArray<T>::push_back(const T& element) const
+{
+	PersistentArray result(*this);
+	result.appendElement(element, 0);
+	return result;
+}
+
+template<class T>
+inline PersistentArray<T> PersistentArray<T>::set(size_t position, const T& element) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return PersistentArray(setRec(root, shift, position, element, 0), shift, size);
+}
+
+template<class T>
+inline PersistentArray<T> PersistentArray<T>::slice(size_t from, size_t to) const
+{
+	if (from > to || to > size)
+		throw std::out_of_range("Out of range\n");
+
+	if (from == to)
+		return PersistentArray();
+
+	NodePtr node = takeRec(root, shift, to);
+	node = dropRec(node, shift, from);
+
+	PersistentArray result(node, shift, to - from);
+	result.trimRoot();
+	return result;
+}
+
+template<class T>
+inline PersistentArray<T> PersistentArray<T>::concat(const PersistentArray& other) const
+{
+	if (other.empty())
+		return *this;
+	if (empty())
+		return other;
+
+	NodePtr node = concatRec(root, shift, other.root, other.shift);
+
+	PersistentArray result(node, (shift > other.shift ? shift : other.shift) + BITS, size + other.size);
+	result.trimRoot();
+	return result;
+}
+
+template<class T>
+inline typename PersistentArray<T>::Transient PersistentArray<T>::transient() const
+{
+	return Transient(*this);
+}
+
+template<class T>
+inline DynamicArray<T> PersistentArray<T>::toDynamicArray() const
+{
+	DynamicArray<T> result(size);
+	if (root)
+		collect(root, shift, result);
+
+	return result;
+}
+
+template<class T>
+inline bool PersistentArray<T>::empty() const
+{
+	return size == 0;
+}
+
+template<class T>
+inline size_t PersistentArray<T>::getSize() const
+{
+	return size;
+}
+
+template<class T>
+inline size_t PersistentArray<T>::nextEdit()
+{
+	static std::atomic<size_t> counter(0);
+	return ++counter;
+}
+
+template<class T>
+inline typename PersistentArray<T>::Leaf* PersistentArray<T>::asLeaf(const NodePtr& node)
+{
+	return static_cast<Leaf*>(node.get());
+}
+
+template<class T>
+inline typename PersistentArray<T>::Inner* PersistentArray<T>::asInner(const NodePtr& node)
+{
+	return static_cast<Inner*>(node.get());
+}
+
+template<class T>
+inline size_t PersistentArray<T>::nodeSize(const NodePtr& node, size_t shift)
+{
+	if (shift == 0)
+		return node->count;
+
+	const Inner* inner = asInner(node);
+	return inner->sizes[inner->count - 1];
+}
+
+template<class T>
+inline size_t PersistentArray<T>::findChild(const Inner* node, size_t shift, size_t& position)
+{
+	size_t index = position >> shift;
+
+	if (!node->relaxed) {
+		position -= index << shift;
+		return index;
+	}
+
+	// Every child holds at most 2^shift elements, so the radix index is a lower bound
+	while (node->sizes[index] <= position)
+		++index;
+
+	if (index > 0)
+		position -= node->sizes[index - 1];
+
+	return index;
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::editable(const NodePtr& node, size_t shift, size_t edit)
+{
+	if (edit != 0 && node->edit == edit)
+		return node;
+
+	NodePtr result;
+	if (shift == 0)
+		result = std::make_shared<Leaf>(*asLeaf(node));
+	else
+		result = std::make_shared<Inner>(*asInner(node));
+
+	result->edit = edit;
+	return result;
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::newPath(size_t shift, const T& element, size_t edit)
+{
+	if (shift == 0) {
+		std::shared_ptr<Leaf> leaf = std::make_shared<Leaf>(edit);
+		leaf->values[0] = element;
+		leaf->count = 1;
+		return leaf;
+	}
+
+	std::shared_ptr<Inner> inner = std::make_shared<Inner>(edit);
+	inner->children[0] = newPath(shift - BITS, element, edit);
+	inner->sizes[0] = 1;
+	inner->count = 1;
+	return inner;
+}
+
+template<class T>
+inline void PersistentArray<T>::updateSizes(Inner* node, size_t shift)
+{
+	size_t total = 0;
+	node->relaxed = false;
+
+	for (size_t i = 0; i < node->count; ++i) {
+		size_t childSize = nodeSize(node->children[i], shift - BITS);
+		total += childSize;
+		node->sizes[i] = total;
+
+		if (i + 1 < node->count && childSize != (size_t(1) << shift))
+			node->relaxed = true;
+	}
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::appendRec(const NodePtr& node, size_t shift, const T& element, size_t edit)
+{
+	if (shift == 0) {
+		if (node->count == BRANCHING)
+			return nullptr;
+
+		NodePtr result = editable(node, shift, edit);
+		Leaf* leaf = asLeaf(result);
+		leaf->values[leaf->count] = element;
+		++leaf->count;
+		return result;
+	}
+
+	const Inner* inner = asInner(node);
+	size_t last = inner->count - 1;
+	NodePtr child = appendRec(inner->children[last], shift - BITS, element, edit);
+
+	if (!child && inner->count == BRANCHING)
+		return nullptr;
+
+	NodePtr result = editable(node, shift, edit);
+	Inner* resultInner = asInner(result);
+
+	if (child) {
+		resultInner->children[last] = child;
+		++resultInner->sizes[last];
+		return result;
+	}
+
+	// The last child is not full if it is relaxed, so the node has to become relaxed too
+	size_t lastSize = resultInner->sizes[last] - (last > 0 ? resultInner->sizes[last - 1] : 0);
+	if (lastSize != (size_t(1) << shift))
+		resultInner->relaxed = true;
+
+	resultInner->children[last + 1] = newPath(shift - BITS, element, edit);
+	resultInner->sizes[last + 1] = resultInner->sizes[last] + 1;
+	++resultInner->count;
+	return result;
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::setRec(const NodePtr& node, size_t shift, size_t position, const T& element, size_t edit)
+{
+	NodePtr result = editable(node, shift, edit);
+
+	if (shift == 0) {
+		asLeaf(result)->values[position] = element;
+		return result;
+	}
+
+	Inner* inner = asInner(result);
+	size_t index = findChild(inner, shift, position);
+	inner->children[index] = setRec(inner->children[index], shift - BITS, position, element, edit);
+	return result;
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::takeRec(const NodePtr& node, size_t shift, size_t count)
+{
+	if (count == nodeSize(node, shift))
+		return node;
+
+	if (shift == 0) {
+		std::shared_ptr<Leaf> leaf = std::make_shared<Leaf>(0);
+		for (size_t i = 0; i < count; ++i)
+			leaf->values[i] = asLeaf(node)->values[i];
+		leaf->count = count;
+		return leaf;
+	}
+
+	const Inner* inner = asInner(node);
+	size_t position = count - 1;
+	size_t index = findChild(inner, shift, position);
+
+	std::shared_ptr<Inner> result = std::make_shared<Inner>(0);
+	for (size_t i = 0; i < index; ++i)
+		result->children[i] = inner->children[i];
+	result->children[index] = takeRec(inner->children[index], shift - BITS, position + 1);
+	result->count = index + 1;
+
+	updateSizes(result.get(), shift);
+	return result;
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::dropRec(const NodePtr& node, size_t shift, size_t count)
+{
+	if (count == 0)
+		return node;
+
+	if (shift == 0) {
+		std::shared_ptr<Leaf> leaf = std::make_shared<Leaf>(0);
+		for (size_t i = count; i < node->count; ++i)
+			leaf->values[i - count] = asLeaf(node)->values[i];
+		leaf->count = node->count - count;
+		return leaf;
+	}
+
+	const Inner* inner = asInner(node);
+	size_t position = count;
+	size_t index = findChild(inner, shift, position);
+
+	std::shared_ptr<Inner> result = std::make_shared<Inner>(0);
+	result->children[0] = dropRec(inner->children[index], shift - BITS, position);
+	for (size_t i = index + 1; i < inner->count; ++i)
+		result->children[i - index] = inner->children[i];
+	result->count = inner->count - index;
+
+	updateSizes(result.get(), shift);
+	return result;
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::concatRec(const NodePtr& left, size_t leftShift, const NodePtr& right, size_t rightShift)
+{
+	if (leftShift > rightShift) {
+		const Inner* leftInner = asInner(left);
+		NodePtr middle = concatRec(leftInner->children[leftInner->count - 1], leftShift - BITS, right, rightShift);
+		return rebalance(left, middle, nullptr, leftShift);
+	}
+
+	if (leftShift < rightShift) {
+		NodePtr middle = concatRec(left, leftShift, asInner(right)->children[0], rightShift - BITS);
+		return rebalance(nullptr, middle, right, rightShift);
+	}
+
+	if (leftShift == 0) {
+		std::shared_ptr<Inner> wrapper = std::make_shared<Inner>(0);
+
+		if (left->count + right->count <= BRANCHING) {
+			std::shared_ptr<Leaf> merged = std::make_shared<Leaf>(*asLeaf(left));
+			merged->edit = 0;
+			for (size_t i = 0; i < right->count; ++i)
+				merged->values[left->count + i] = asLeaf(right)->values[i];
+			merged->count += right->count;
+
+			wrapper->children[0] = merged;
+			wrapper->count = 1;
+		}
+		else {
+			wrapper->children[0] = left;
+			wrapper->children[1] = right;
+			wrapper->count = 2;
+		}
+
+		updateSizes(wrapper.get(), BITS);
+		return wrapper;
+	}
+
+	const Inner* leftInner = asInner(left);
+	NodePtr middle = concatRec(leftInner->children[leftInner->count - 1], leftShift - BITS, asInner(right)->children[0], rightShift - BITS);
+	return rebalance(left, middle, right, leftShift);
+}
+
+template<class T>
+inline typename PersistentArray<T>::NodePtr PersistentArray<T>::rebalance(const NodePtr& left, const NodePtr& middle, const NodePtr& right, size_t shift)
+{
+	// At most 31 children of left, 2 of middle and 31 of right
+	NodePtr all[2 * BRANCHING];
+	size_t counts[2 * BRANCHING];
+	size_t length = 0;
+	size_t total = 0;
+
+	const Inner* leftInner = asInner(left);
+	const Inner* middleInner = asInner(middle);
+	const Inner* rightInner = asInner(right);
+
+	if (leftInner) {
+		for (size_t i = 0; i + 1 < leftInner->count; ++i)
+			all[length++] = leftInner->children[i];
+	}
+	for (size_t i = 0; i < middleInner->count; ++i)
+		all[length++] = middleInner->children[i];
+	if (rightInner) {
+		for (size_t i = 1; i < rightInner->count; ++i)
+			all[length++] = rightInner->children[i];
+	}
+
+	for (size_t i = 0; i < length; ++i) {
+		counts[i] = all[i]->count;
+		total += counts[i];
+	}
+
+	// Concatenation plan: merge the underfull nodes into their right neighbours
+	// until there are at most MAX_EXTRAS nodes more than the optimal number
+	size_t optimal = (total + BRANCHING - 1) / BRANCHING;
+	size_t planLength = length;
+	size_t i = 0;
+
+	while (optimal + MAX_EXTRAS < planLength) {
+		while (counts[i] > BRANCHING - MAX_EXTRAS / 2)
+			++i;
+
+		size_t remaining = counts[i];
+		do {
+			size_t minSize = remaining + counts[i + 1] < BRANCHING ? remaining + counts[i + 1] : BRANCHING;
+			remaining = remaining + counts[i + 1] - minSize;
+			counts[i] = minSize;
+			++i;
+		} while (remaining > 0);
+
+		for (size_t j = i; j + 1 < planLength; ++j)
+			counts[j] = counts[j + 1];
+
+		--planLength;
+		--i;
+	}
+
+	// Execute the plan. The nodes which are not changed by it are reused
+	size_t childShift = shift - BITS;
+	NodePtr planned[2 * BRANCHING];
+	size_t source = 0;
+	size_t offset = 0;
+
+	for (size_t k = 0; k < planLength; ++k) {
+		if (offset == 0 && all[source]->count == counts[k]) {
+			planned[k] = all[source];
+			++source;
+			continue;
+		}
+
+		NodePtr node;
+		if (childShift == 0)
+			node = std::make_shared<Leaf>(0);
+		else
+			node = std::make_shared<Inner>(0);
+
+		while (node->count < counts[k]) {
+			size_t available = all[source]->count - offset;
+			size_t needed = counts[k] - node->count;
+			size_t moved = available < needed ? available : needed;
+
+			for (size_t m = 0; m < moved; ++m) {
+				if (childShift == 0)
+					asLeaf(node)->values[node->count + m] = asLeaf(all[source])->values[offset + m];
+				else
+					asInner(node)->children[node->count + m] = asInner(all[source])->children[offset + m];
+			}
+
+			node->count += moved;
+			offset += moved;
+			if (offset == all[source]->count) {
+				++source;
+				offset = 0;
+			}
+		}
+
+		if (childShift != 0)
+			updateSizes(asInner(node), childShift);
+
+		planned[k] = node;
+	}
+
+	// Pack the planned nodes into one or two nodes and wrap them in a parent
+	std::shared_ptr<Inner> wrapper = std::make_shared<Inner>(0);
+	for (size_t k = 0; k < planLength; k += BRANCHING) {
+		std::shared_ptr<Inner> node = std::make_shared<Inner>(0);
+		for (size_t m = k; m < planLength && m < k + BRANCHING; ++m)
+			node->children[node->count++] = planned[m];
+
+		updateSizes(node.get(), shift);
+		wrapper->children[wrapper->count++] = node;
+	}
+
+	updateSizes(wrapper.get(), shift + BITS);
+	return wrapper;
+}
+
+template<class T>
+inline void PersistentArray<T>::collect(const NodePtr& node, size_t shift, DynamicArray<T>& result)
+{
+	if (shift == 0) {
+		const Leaf* leaf = asLeaf(node);
+		for (size_t i = 0; i < leaf->count; ++i)
+			result.push_back(leaf->values[i]);
+		return;
+	}
+
+	const Inner* inner = asInner(node);
+	for (size_t i = 0; i < inner->count; ++i)
+		collect(inner->children[i], shift - BITS, result);
+}
+
+template<class T>
+inline void PersistentArray<T>::trimRoot()
+{
+	while (shift > 0 && root->count == 1) {
+		root = asInner(root)->children[0];
+		shift -= BITS;
+	}
+}
+
+template<class T>
+inline void PersistentArray<T>::appendElement(const T& element, size_t edit)
+{
+	if (!root) {
+		root = newPath(0, element, edit);
+		shift = 0;
+		size = 1;
+		return;
+	}
+
+	NodePtr result = appendRec(root, shift, element, edit);
+
+	if (!result) {
+		// The tree is full, so it grows by one level
+		std::shared_ptr<Inner> newRoot = std::make_shared<Inner>(edit);
+		newRoot->children[0] = root;
+		newRoot->children[1] = newPath(shift, element, edit);
+		newRoot->sizes[0] = size;
+		newRoot->sizes[1] = size + 1;
+		newRoot->count = 2;
+		newRoot->relaxed = size != (size_t(1) << (shift + BITS));
+
+		result = newRoot;
+		shift += BITS;
+	}
+
+	root = result;
+	++size;
+}
+
+template<class T>
+inline const T& PersistentArray<T>::get(size_t position) const
+{
+	const Node* node = root.get();
+
+	for (size_t level = shift; level > 0; level -= BITS) {
+		const Inner* inner = static_cast<const Inner*>(node);
+		node = inner->children[findChild(inner, level, position)].get();
+	}
+
+	return static_cast<const Leaf*>(node)->values[position];
+}
+
+template<class T>
+inline PersistentArray<T>::Transient::Transient(const PersistentArray& arr) : arr(arr), edit(nextEdit())
+{
+}
+
+template<class T>
+inline PersistentArray<T>::Transient::Transient(Transient&& other) : arr(std::move(other.arr)), edit(other.edit)
+{
+	other.arr = PersistentArray();
+	other.edit = nextEdit();
+}
+
+template<class T>
+inline typename PersistentArray<T>::Transient& PersistentArray<T>::Transient::operator=(Transient&& other)
+{
+	if (this != &other) {
+		arr = std::move(other.arr);
+		edit = other.edit;
+		other.arr = PersistentArray();
+		other.edit = nextEdit();
+	}
+	return *this;
+}
+
+template<class T>
+inline const T& PersistentArray<T>::Transient::operator[](size_t position) const
+{
+	return arr[position];
+}
+
+template<class T>
+inline void PersistentArray<T>::Transient::push_back(const T& element)
+{
+	arr.appendElement(element, edit);
+}
+
+template<class T>
+inline void PersistentArray<T>::Transient::set(size_t position, const T& element)
+{
+	if (arr.size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	arr.root = setRec(arr.root, arr.shift, position, element, edit);
+}
+
+template<class T>
+inline PersistentArray<T> PersistentArray<T>::Transient::persistent()
+{
+	// The nodes created so far become immutable, later changes copy them
+	edit = nextEdit();
+	return arr;
+}
+
+template<class T>
+inline size_t PersistentArray<T>::Transient::getSize() const
+{
+	return arr.size;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+//! Size of a cache line in bytes
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+//! Hints the processor to load the cache line with the given address. Never faults
+inline void prefetch(const void* address)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch((const char*)address, _MM_HINT_T0);
+#elif defined(__GNUC__)
+	__builtin_prefetch(address);
+#else
+	(void)address;
+#endif
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <initializer_list>
+#include <stdexcept>
+#include "Container.h"
+#include "Span.h"
+
+/**
+* \brief Circular buffer with O(1) operations on both ends
+*
+* The elements are stored in a Container buffer starting at position head and wrapping around its end.
+* The capacity is always a power of two, so a logical position is mapped to the buffer with a mask.
+*/
+template <class T>
+class RingArray
+{
+private:
+	static constexpr size_t INITIAL_CAPACITY = 4;
+
+public:
+
+	//! Default constructor
+	RingArray();
+	//! Constructs the object by allocating memory. The capacity is rounded up to a power of two
+	RingArray(size_t capacity);
+	//! Copy constructor
+	RingArray(const RingArray<T>& other);
+	//! Constructs the object by the elements of a given initializer list
+	RingArray(const std::initializer_list<T>& lst);
+
+	//! Operator =
+	RingArray& operator=(const RingArray<T>& other);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* Position 0 is the front of the array.
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const T& operator[](size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* Position 0 is the front of the array.
+	* If the position is invalid, the behaviour is undefined
+	*/
+	T& operator[](size_t position);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	const T& at(size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	T& at(size_t position);
+
+	//! Access the first element. If the array is empty, the behaviour is undefined
+	const T& front() const;
+	//! Access the first element. If the array is empty, the behaviour is undefined
+	T& front();
+	//! Access the last element. If the array is empty, the behaviour is undefined
+	const T& back() const;
+	//! Access the last element. If the array is empty, the behaviour is undefined
+	T& back();
+
+	/**
+	* \brief Add an element on the back
+	*
+	* If the array is full then it's capacity is doubled. Otherwise the operation is O(1).
+	*/
+	void push_back(const T& element);
+
+	/**
+	* \brief Add an element on the front
+	*
+	* If the array is full then it's capacity is doubled. Otherwise the operation is O(1).
+	*/
+	void push_front(const T& element);
+
+	/**
+	* \brief Remove the last element
+	*
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_back();
+
+	/**
+	* \brief Remove the first element
+	*
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_front();
+
+	/**
+	* \brief Reserve extra space
+	*
+	* Changes the capacity to the smallest power of two not less than the given one, only if it is greater than the current one.
+	* The elements are copied to the beginning of the new buffer in at most two bulk copies.
+	*/
+	void reserve(size_t newCapacity);
+
+	/**
+	* \brief Access the elements as contiguous ranges
+	*
+	* The elements from the front up to the end of the buffer.
+	* Together with getSecondSpan() it covers all elements in order.
+	*/
+	Span<const T> getFirstSpan() const;
+	Span<T> getFirstSpan();
+
+	/**
+	* \brief Access the elements as contiguous ranges
+	*
+	* The elements which wrapped around to the beginning of the buffer. Empty if the elements don't wrap.
+	*/
+	Span<const T> getSecondSpan() const;
+	Span<T> getSecondSpan();
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+	//! Return capacity
+	size_t getCapacity() const;
+
+private:
+
+	//! Smallest power of two not less than the capacity and the initial capacity
+	static size_t roundCapacity(size_t capacity);
+	/**
+	* \brief Check the capacity of a new buffer
+	*
+	* Positions are mapped to indices with a mask, so the capacity must be a power of two.
+	* If the Container gave any other capacity, throws a logic_error exception
+	*/
+	static void checkCapacity(const Container<T>& buffer);
+
+	//! Maps a logical position to an index in the buffer
+	size_t toIndex(size_t position) const;
+	//! Copies the elements of other to the beginning of the buffer
+	void copy(const RingArray<T>& other);
+
+
+	// Class members:
+
+	Container<T> data;
+	size_t head; //!< Buffer index of the first element
+	size_t size; //!< Number of elements stored in the array
+};
+
+#include "RingArray.ipp"
@@ -0,0 +1,236 @@
+#include "RingArray.h"
+
+template<class T>
+inline RingArray<T>::RingArray() : data(), head(0), size(0)
+{
+}
+
+template<class T>
+inline RingArray<T>::RingArray(size_t capacity) : data(roundCapacity(capacity)), head(0), size(0)
+{
+	checkCapacity(data);
+}
+
+template<class T>
+inline RingArray<T>::RingArray(const RingArray<T>& other) : data(), head(0), size(0)
+{
+	copy(other);
+}
+
+template<class T>
+inline RingArray<T>::RingArray(const std::initializer_list<T>& lst) : RingArray(lst.size())
+{
+	for (const T& element : lst)
+		data[size++] = element;
+}
+
+template<class T>
+inline RingArray<T>& RingArray<T>::operator=(const RingArray<T>& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+template<class T>
+inline const T& RingArray<T>::operator[](size_t position) const
+{
+	return data[toIndex(position)];
+}
+
+template<class T>
+inline T& RingArray<T>::operator[](size_t position)
+{
+	return const_cast<T&>(const_cast<const RingArray&>(*this)[position]);
+}
+
+template<class T>
+inline const T& RingArray<T>::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return data[toIndex(position)];
+}
+
+template<class T>
+inline T& RingArray<T>::at(size_t position)
+{
+	return const_cast<T&>(const_cast<const RingArray&>(*this).at(position));
+}
+
+template<class T>
+inline const T& RingArray<T>::front() const
+{
+	return data[head];
+}
+
+template<class T>
+inline T& RingArray<T>::front()
+{
+	return const_cast<T&>(const_cast<const RingArray&>(*this).front());
+}
+
+template<class T>
+inline const T& RingArray<T>::back() const
+{
+	return data[toIndex(size - 1)];
+}
+
+template<class T>
+inline T& RingArray<T>::back()
+{
+	return const_cast<T&>(const_cast<const RingArray&>(*this).back());
+}
+
+template<class T>
+inline void RingArray<T>::push_back(const T& element)
+{
+	if (size == data.getCap())
+		reserve(size < INITIAL_CAPACITY ? INITIAL_CAPACITY : size * 2);
+
+	data[toIndex(size)] = element;
+	++size;
+}
+
+template<class T>
+inline void RingArray<T>::push_front(const T& element)
+{
+	if (size == data.getCap())
+		reserve(size < INITIAL_CAPACITY ? INITIAL_CAPACITY : size * 2);
+
+	head = (head - 1) & (data.getCap() - 1);
+	data[head] = element;
+	++size;
+}
+
+template<class T>
+inline void RingArray<T>::pop_back()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	--size;
+}
+
+template<class T>
+inline void RingArray<T>::pop_front()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	head = (head + 1) & (data.getCap() - 1);
+	--size;
+}
+
+template<class T>
+inline void RingArray<T>::reserve(size_t newCapacity)
+{
+	if (newCapacity <= data.getCap())
+		return;
+
+	Container<T> temp(roundCapacity(newCapacity));
+	checkCapacity(temp);
+
+	// Unroll the ring: the part up to the end of the buffer, then the wrapped part
+	const RingArray& self = *this;
+	Span<const T> first = self.getFirstSpan();
+	Span<const T> second = self.getSecondSpan();
+	for (size_t i = 0; i < first.getSize(); ++i)
+		temp[i] = first[i];
+	for (size_t i = 0; i < second.getSize(); ++i)
+		temp[first.getSize() + i] = second[i];
+
+	data.swap(temp);
+	head = 0;
+}
+
+template<class T>
+inline Span<const T> RingArray<T>::getFirstSpan() const
+{
+	if (empty())
+		return Span<const T>();
+
+	size_t length = data.getCap() - head < size ? data.getCap() - head : size;
+	return Span<const T>(data.getData() + head, length);
+}
+
+template<class T>
+inline Span<T> RingArray<T>::getFirstSpan()
+{
+	Span<const T> span = const_cast<const RingArray&>(*this).getFirstSpan();
+	return Span<T>(const_cast<T*>(span.getData()), span.getSize());
+}
+
+template<class T>
+inline Span<const T> RingArray<T>::getSecondSpan() const
+{
+	if (head + size <= data.getCap())
+		return Span<const T>();
+
+	return Span<const T>(data.getData(), head + size - data.getCap());
+}
+
+template<class T>
+inline Span<T> RingArray<T>::getSecondSpan()
+{
+	Span<const T> span = const_cast<const RingArray&>(*this).getSecondSpan();
+	return Span<T>(const_cast<T*>(span.getData()), span.getSize());
+}
+
+template<class T>
+inline bool RingArray<T>::empty() const
+{
+	return size == 0;
+}
+
+template<class T>
+inline size_t RingArray<T>::getSize() const
+{
+	return size;
+}
+
+template<class T>
+inline size_t RingArray<T>::getCapacity() const
+{
+	return data.getCap();
+}
+
+template<class T>
+inline size_t RingArray<T>::roundCapacity(size_t capacity)
+{
+	size_t result = INITIAL_CAPACITY;
+	while (result < capacity)
+		result *= 2;
+
+	return result;
+}
+
+template<class T>
+inline void RingArray<T>::checkCapacity(const Container<T>& buffer)
+{
+	if ((buffer.getCap() & (buffer.getCap() - 1)) != 0)
+		throw std::logic_error("Ring capacity must be a power of two\n");
+}
+
+template<class T>
+inline size_t RingArray<T>::toIndex(size_t position) const
+{
+	return (head + position) & (data.getCap() - 1);
+}
+
+template<class T>
+inline void RingArray<T>::copy(const RingArray<T>& other)
+{
+	if (data.getCap() < other.size) {
+		Container<T> temp(roundCapacity(other.size));
+		checkCapacity(temp);
+		data.swap(temp);
+	}
+
+	for (size_t i = 0; i < other.size; ++i)
+		data[i] = other[i];
+
+	head = 0;
+	size = other.size;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+/**
+* \brief Branchless binary search
+*
+* Returns the index of the first element of the sorted range which is not less than key,
+* or size if there is none. The loop always runs log2(size) times and the only decision
+* in it is a conditional move, so it doesn't suffer from branch mispredictions.
+*/
+template <class T, class K, class Compare>
+inline size_t branchlessLowerBound(const T* data, size_t size, const K& key, Compare less)
+{
+	if (size == 0)
+		return 0;
+
+	const T* base = data;
+	while (size > 1) {
+		size_t half = size / 2;
+		base = less(base[half], key) ? base + half : base;
+		size -= half;
+	}
+
+	return (base - data) + (less(*base, key) ? 1 : 0);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "DynamicArray.h"
+
+/**
+* \brief Container which gives stable handles to its elements
+*
+* The elements are packed in a dynamic array, so iterating over them is a linear scan. A handle
+* refers to a slot of an indirection table, which holds the current position of the element and
+* a generation counter. Erasing moves the last element into the hole and increases the generation
+* of the slot, so handles to erased elements are detected instead of reaching a new element.
+* Free slots form a linked list and are reused first. Insert, erase and lookup take O(1) time.
+*/
+template <class T>
+class SlotMap
+{
+private:
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+public:
+
+	//! Identifies an element for as long as it is in the map
+	struct Handle
+	{
+		//! Creates a handle which refers to no element
+		Handle() : index(NONE), generation(0) {}
+		Handle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+		bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+
+		uint32_t index;      //!< Slot in the indirection table
+		uint32_t generation; //!< Generation of the slot when the element was inserted
+	};
+
+	//! Default constructor
+	SlotMap();
+
+	//! Adds an element and returns its handle
+	Handle insert(const T& value);
+
+	/**
+	* \brief Remove an element
+	*
+	* The last element is moved to its position, so positions of other elements may change.
+	* \return True if the element was removed
+	* \return False if the handle refers to no element
+	*/
+	bool erase(Handle handle);
+
+	//! Check if the handle refers to an element of the map
+	bool contains(Handle handle) const;
+
+	//! Returns a pointer to the element of the handle, nullptr if there is none
+	const T* find(Handle handle) const;
+	//! Returns a pointer to the element of the handle, nullptr if there is none
+	T* find(Handle handle);
+
+	/**
+	* \brief Access an element by handle
+	*
+	* If the handle refers to no element, throws an out_of_range exception
+	*/
+	const T& at(Handle handle) const;
+
+	/**
+	* \brief Access an element by handle
+	*
+	* If the handle refers to no element, throws an out_of_range exception
+	*/
+	T& at(Handle handle);
+
+	/**
+	* \brief Access an element by position in the packed array
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const T& operator[](size_t position) const;
+
+	/**
+	* \brief Access an element by position in the packed array
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	T& operator[](size_t position);
+
+	//! Return the handle of the element at the given position of the packed array
+	Handle getHandle(size_t position) const;
+
+	//! Return the packed array of elements
+	const DynamicArray<T>& getValues() const;
+
+	/**
+	* \brief Check if the map is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return the number of elements
+	size_t getSize() const;
+
+private:
+
+	//! Entry of the indirection table
+	struct Slot
+	{
+		uint32_t position;   //!< Position of the element in the packed array, or the next free slot
+		uint32_t generation; //!< Increased every time the element of the slot is erased
+	};
+
+	//! Position of the element of the handle, NONE if there is none
+	uint32_t positionOf(Handle handle) const;
+
+
+	// Class members:
+
+	DynamicArray<T> values;
+	DynamicArray<uint32_t> owners; //!< Slot of every element of the packed array
+	DynamicArray<Slot> slots;
+	uint32_t freeHead;             //!< First free slot, NONE if there is none
+};
+
+#include "SlotMap.ipp"
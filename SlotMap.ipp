@@ -0,0 +1,136 @@
+#include "SlotMap.h"
+
+template<class T>
+inline SlotMap<T>::SlotMap() : values(), owners(), slots(), freeHead(NONE)
+{
+}
+
+template<class T>
+inline typename SlotMap<T>::Handle SlotMap<T>::insert(const T& value)
+{
+	uint32_t index = freeHead;
+	if (index == NONE) {
+		index = (uint32_t)slots.getSize();
+		slots.push_back(Slot{ 0, 0 });
+	}
+	else {
+		freeHead = slots[index].position;
+	}
+
+	slots[index].position = (uint32_t)values.getSize();
+	values.push_back(value);
+	owners.push_back(index);
+
+	return Handle(index, slots[index].generation);
+}
+
+template<class T>
+inline bool SlotMap<T>::erase(Handle handle)
+{
+	uint32_t position = positionOf(handle);
+	if (position == NONE)
+		return false;
+
+	// Swap and pop: the last element takes the place of the erased one
+	uint32_t last = (uint32_t)values.getSize() - 1;
+	if (position != last) {
+		values[position] = values[last];
+		owners[position] = owners[last];
+		slots[owners[position]].position = position;
+	}
+	values.pop_back();
+	owners.pop_back();
+
+	Slot& slot = slots[handle.index];
+	++slot.generation;
+	slot.position = freeHead;
+	freeHead = handle.index;
+
+	return true;
+}
+
+template<class T>
+inline bool SlotMap<T>::contains(Handle handle) const
+{
+	return positionOf(handle) != NONE;
+}
+
+template<class T>
+inline const T* SlotMap<T>::find(Handle handle) const
+{
+	uint32_t position = positionOf(handle);
+	return position == NONE ? nullptr : &values[position];
+}
+
+template<class T>
+inline T* SlotMap<T>::find(Handle handle)
+{
+	return const_cast<T*>(const_cast<const SlotMap&>(*this).find(handle));
+}
+
+template<class T>
+inline const T& SlotMap<T>::at(Handle handle) const
+{
+	const T* value = find(handle);
+	if (!value)
+		throw std::out_of_range("Invalid handle\n");
+
+	return *value;
+}
+
+template<class T>
+inline T& SlotMap<T>::at(Handle handle)
+{
+	return const_cast<T&>(const_cast<const SlotMap&>(*this).at(handle));
+}
+
+template<class T>
+inline const T& SlotMap<T>::operator[](size_t position) const
+{
+	return values[position];
+}
+
+template<class T>
+inline T& SlotMap<T>::operator[](size_t position)
+{
+	return values[position];
+}
+
+template<class T>
+inline typename SlotMap<T>::Handle SlotMap<T>::getHandle(size_t position) const
+{
+	uint32_t index = owners[position];
+	return Handle(index, slots[index].generation);
+}
+
+template<class T>
+inline const DynamicArray<T>& SlotMap<T>::getValues() const
+{
+	return values;
+}
+
+template<class T>
+inline bool SlotMap<T>::empty() const
+{
+	return values.empty();
+}
+
+template<class T>
+inline size_t SlotMap<T>::getSize() const
+{
+	return values.getSize();
+}
+
+template<class T>
+inline uint32_t SlotMap<T>::positionOf(Handle handle) const
+{
+	if (handle.index >= slots.getSize())
+		return NONE;
+
+	// Free slots have a generation no live handle was given
+	const Slot& slot = slots[handle.index];
+	if (slot.generation != handle.generation)
+		return NONE;
+
+	return slot.position;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <atomic>
+#include <stdexcept>
+#include "Container.h"
+#include "DynamicArray.h"
+
+/**
+* \brief Append-only array with one writer and lock-free snapshot readers
+*
+* The writer adds elements with push_back() and reserve(). Readers take snapshots, which are
+* immutable (pointer, size) views of the array at the moment they were taken.
+* Taking a snapshot never waits for the writer and a snapshot never sees a half finished reallocation.
+* When the buffer grows, the old one is retired and freed only after every snapshot which could still
+* reference it has been released (epoch based reclamation).
+*
+* Only one thread may call the writer methods at a time. snapshot() may be called from any thread.
+*/
+template <class T>
+class SnapshotArray
+{
+private:
+	static constexpr float RESIZE_FACTOR = 1.6f;
+	static constexpr size_t MAX_READERS = 128;
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct Buffer;
+	struct ReaderSlot;
+
+public:
+
+	class Snapshot;
+
+	//! Default constructor
+	SnapshotArray();
+	//! Constructs the object by allocating memory
+	SnapshotArray(size_t capacity);
+	//! Frees all buffers. There must be no snapshots left
+	~SnapshotArray();
+
+	SnapshotArray(const SnapshotArray&) = delete;
+	SnapshotArray& operator=(const SnapshotArray&) = delete;
+
+	/**
+	* \brief Add an element
+	*
+	* Adds an element on the back of the array and publishes the new size to the readers.
+	* If the array is full, the elements are copied into a bigger buffer which is published instead
+	* and the old buffer is retired.
+	* Writer only.
+	*/
+	void push_back(const T& element);
+
+	/**
+	* \brief Reserve extra space
+	*
+	* Changes the capacity of the array to the given one, only if it is greater than the current one.
+	* Writer only.
+	*/
+	void reserve(size_t newCapacity);
+
+	/**
+	* \brief Take a snapshot
+	*
+	* Returns a view of the elements stored at the moment of the call.
+	* The view stays valid until the snapshot is destroyed, regardless of the changes made by the writer.
+	* If there are more than MAX_READERS snapshots alive at the same time, the call spins until one is released.
+	*/
+	Snapshot snapshot() const;
+
+	/**
+	* \brief Free the retired buffers
+	*
+	* Frees the retired buffers which are not referenced by any snapshot.
+	* Called automatically on every growth. Writer only.
+	*/
+	void reclaim();
+
+	//! Return size
+	size_t getSize() const;
+	//! Return capacity
+	size_t getCapacity() const;
+	//! Return the number of retired buffers still waiting for their readers
+	size_t getRetiredCount() const;
+
+private:
+
+	struct Buffer {
+		Buffer(size_t capacity) : storage(capacity), size(0) {}
+
+		Container<T> storage;
+		std::atomic<size_t> size; //!< Number of elements published to the readers
+	};
+
+	//! Epoch announced by a reader. Padded to a cache line so the readers don't share lines
+	struct alignas(CACHE_LINE) ReaderSlot {
+		ReaderSlot() : epoch(0) {}
+
+		std::atomic<size_t> epoch; //!< 0 if the slot is free
+	};
+
+	struct Retired {
+		Buffer* buffer;
+		size_t epoch; //!< The buffer may be freed when no reader has announced an older epoch
+	};
+
+	//! Copies the elements into a new buffer, publishes it and retires the old one
+	void grow(size_t newCapacity);
+
+
+	// Class members:
+
+	std::atomic<Buffer*> current;
+	mutable std::atomic<size_t> epoch;
+	mutable ReaderSlot readers[MAX_READERS];
+	DynamicArray<Retired> retired;
+};
+
+/**
+* \brief Immutable view of a snapshot array
+*
+* Holds the epoch guard of its reader until it is destroyed. Can be moved but not copied.
+*/
+template <class T>
+class SnapshotArray<T>::Snapshot
+{
+public:
+
+	Snapshot(Snapshot&& other);
+	~Snapshot();
+
+	Snapshot(const Snapshot&) = delete;
+	Snapshot& operator=(const Snapshot&) = delete;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, the behaviour is undefined
+	*/
+	const T& operator[](size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	const T& at(size_t position) const;
+
+	//! Return pointer to the first element
+	const T* getData() const;
+	//! Return size
+	size_t getSize() const;
+	//! Check if the snapshot is empty
+	bool empty() const;
+
+private:
+	friend class SnapshotArray<T>;
+
+	Snapshot(ReaderSlot* slot, const T* data, size_t size);
+
+	ReaderSlot* slot;
+	const T* data;
+	size_t size;
+};
+
+#include "SnapshotArray.ipp"
@@ -0,0 +1,175 @@
+#include "SnapshotArray.h"
+#include <thread>
+
+template<class T>
+inline SnapshotArray<T>::SnapshotArray() : SnapshotArray(0)
+{
+}
+
+template<class T>
+inline SnapshotArray<T>::SnapshotArray(size_t capacity) : current(new Buffer(capacity)), epoch(1)
+{
+}
+
+template<class T>
+inline SnapshotArray<T>::~SnapshotArray()
+{
+	for (size_t i = 0; i < retired.getSize(); ++i)
+		delete retired[i].buffer;
+
+	delete current.load();
+}
+
+template<class T>
+inline void SnapshotArray<T>::push_back(const T& element)
+{
+	Buffer* buffer = current.load(std::memory_order_relaxed);
+	size_t size = buffer->size.load(std::memory_order_relaxed);
+
+	if (size == buffer->storage.getCap()) {
+		size_t newCapacity = (size_t)(buffer->storage.getCap() * RESIZE_FACTOR);
+		if (newCapacity < buffer->storage.getInitCap())
+			newCapacity = buffer->storage.getInitCap();
+
+		grow(newCapacity);
+		buffer = current.load(std::memory_order_relaxed);
+	}
+
+	// The slot is beyond every published size, so no reader can see it before the release store
+	buffer->storage[size] = element;
+	buffer->size.store(size + 1, std::memory_order_release);
+}
+
+template<class T>
+inline void SnapshotArray<T>::reserve(size_t newCapacity)
+{
+	if (newCapacity > current.load(std::memory_order_relaxed)->storage.getCap())
+		grow(newCapacity);
+}
+
+template<class T>
+inline typename SnapshotArray<T>::Snapshot SnapshotArray<T>::snapshot() const
+{
+	for (;;) {
+		for (size_t i = 0; i < MAX_READERS; ++i) {
+			size_t free = 0;
+
+			// The epoch is announced before the buffer is loaded, so the writer can't free it in between
+			if (readers[i].epoch.compare_exchange_strong(free, epoch.load())) {
+				const Buffer* buffer = current.load();
+				size_t size = buffer->size.load(std::memory_order_acquire);
+				return Snapshot(&readers[i], buffer->storage.getData(), size);
+			}
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+template<class T>
+inline void SnapshotArray<T>::reclaim()
+{
+	size_t oldest = 0;
+	for (size_t i = 0; i < MAX_READERS; ++i) {
+		size_t readerEpoch = readers[i].epoch.load();
+		if (readerEpoch != 0 && (oldest == 0 || readerEpoch < oldest))
+			oldest = readerEpoch;
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < retired.getSize(); ++i) {
+		if (oldest == 0 || oldest >= retired[i].epoch)
+			delete retired[i].buffer;
+		else
+			retired[kept++] = retired[i];
+	}
+
+	retired.resize(kept);
+}
+
+template<class T>
+inline size_t SnapshotArray<T>::getSize() const
+{
+	return current.load()->size.load(std::memory_order_relaxed);
+}
+
+template<class T>
+inline size_t SnapshotArray<T>::getCapacity() const
+{
+	return current.load()->storage.getCap();
+}
+
+template<class T>
+inline size_t SnapshotArray<T>::getRetiredCount() const
+{
+	return retired.getSize();
+}
+
+template<class T>
+inline void SnapshotArray<T>::grow(size_t newCapacity)
+{
+	Buffer* old = current.load(std::memory_order_relaxed);
+	size_t size = old->size.load(std::memory_order_relaxed);
+
+	Buffer* buffer = new Buffer(newCapacity);
+	for (size_t i = 0; i < size; ++i)
+		buffer->storage[i] = old->storage[i];
+	buffer->size.store(size, std::memory_order_relaxed);
+
+	current.store(buffer);
+
+	// Readers which announced an epoch before the increment may still hold the old buffer
+	retired.push_back(Retired{ old, ++epoch });
+	reclaim();
+}
+
+template<class T>
+inline SnapshotArray<T>::Snapshot::Snapshot(ReaderSlot* slot, const T* data, size_t size) : slot(slot), data(data), size(size)
+{
+}
+
+template<class T>
+inline SnapshotArray<T>::Snapshot::Snapshot(Snapshot&& other) : slot(other.slot), data(other.data), size(other.size)
+{
+	other.slot = nullptr;
+}
+
+template<class T>
+inline SnapshotArray<T>::Snapshot::~Snapshot()
+{
+	if (slot)
+		slot->epoch.store(0, std::memory_order_release);
+}
+
+template<class T>
+inline const T& SnapshotArray<T>::Snapshot::operator[](size_t position) const
+{
+	return data[position];
+}
+
+template<class T>
+inline const T& SnapshotArray<T>::Snapshot::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return data[position];
+}
+
+template<class T>
+inline const T* SnapshotArray<T>::Snapshot::getData() const
+{
+	return data;
+}
+
+template<class T>
+inline size_t SnapshotArray<T>::Snapshot::getSize() const
+{
+	return size;
+}
+
+template<class T>
+inline bool SnapshotArray<T>::Snapshot::empty() const
+{
+	return size == 0;
+}
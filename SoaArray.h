@@ -0,0 +1,185 @@
+#pragma once
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "Container.h"
+#include "DynamicArray.h"
+#include "Span.h"
+
+/**
+* \brief Dynamic array stored as a structure of arrays
+*
+* Every field type gets its own contiguous column, so a scan that reads only some of the fields
+* touches only their columns. All columns share the size and the capacity and grow together.
+* An element is accessed through a proxy reference, which is a tuple of references to its fields.
+*/
+template <class... Fields>
+class SoaArray
+{
+private:
+	static_assert(sizeof...(Fields) > 0, "SoaArray needs at least one field");
+
+	static constexpr float RESIZE_FACTOR = 1.6f;
+
+	using Indices = std::index_sequence_for<Fields...>;
+
+public:
+
+	//! Type of the field with the given index
+	template <size_t I>
+	using Field = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+	//! Proxy reference to an element
+	using Reference = std::tuple<Fields&...>;
+	//! Proxy reference to a const element
+	using ConstReference = std::tuple<const Fields&...>;
+
+	//! Default constructor
+	SoaArray();
+	//! Constructs the object by allocating memory for every column
+	SoaArray(size_t capacity);
+	//! Copy constructor
+	SoaArray(const SoaArray& other);
+
+	//! Operator =
+	SoaArray& operator=(const SoaArray& other);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* Returns a tuple of references to the fields of the element.
+	* If the position is invalid, the behaviour is undefined
+	*/
+	ConstReference operator[](size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* Returns a tuple of references to the fields of the element. Assigning a tuple of values to it changes the element.
+	* If the position is invalid, the behaviour is undefined
+	*/
+	Reference operator[](size_t position);
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	ConstReference at(size_t position) const;
+
+	/**
+	* \brief Access an element at given position
+	*
+	* If the position is invalid, throws an out_of_range exception
+	*/
+	Reference at(size_t position);
+
+	//! Access a single field of an element. If the position is invalid, the behaviour is undefined
+	template <size_t I>
+	const Field<I>& get(size_t position) const;
+
+	//! Access a single field of an element. If the position is invalid, the behaviour is undefined
+	template <size_t I>
+	Field<I>& get(size_t position);
+
+	/**
+	* \brief Access a whole column
+	*
+	* Returns a contiguous view of the field with the given index of all elements.
+	* The view is invalidated when the array grows.
+	*/
+	template <size_t I>
+	Span<const Field<I>> column() const;
+
+	//! Access a whole column. The view is invalidated when the array grows
+	template <size_t I>
+	Span<Field<I>> column();
+
+	/**
+	* \brief Add an element
+	*
+	* Adds the fields on the back of their columns.
+	* If the array is full then the capacity of all columns is increased at once.
+	*/
+	void push_back(const Fields&... values);
+
+	//! Adds an element given as a tuple of its fields
+	void push_back(const std::tuple<Fields...>& element);
+
+	/**
+	* \brief Remove an element
+	*
+	* Removes the element at the last position.
+	* Trying to execute the method on empty array will throw an exception
+	*/
+	void pop_back();
+
+	/**
+	* \brief Resize the array
+	*
+	* Changes the size of the array to the given one. The value of the new elements is undefined.
+	*/
+	void resize(size_t newSize);
+
+	/**
+	* \brief Reserve extra space
+	*
+	* Changes the capacity of every column to the given one, only if it is greater than the current one.
+	*/
+	void reserve(size_t newCapacity);
+
+	/**
+	* \brief Build from an array of structures
+	*
+	* split is called for every element and must return a std::tuple with its fields.
+	*/
+	template <class S, class Split>
+	static SoaArray fromArray(const DynamicArray<S>& arr, Split split);
+
+	/**
+	* \brief Convert to an array of structures
+	*
+	* Every element is created as S{ field0, field1, ... }.
+	*/
+	template <class S>
+	DynamicArray<S> toArray() const;
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return size
+	size_t getSize() const;
+	//! Return capacity, the smallest capacity of the columns
+	size_t getCapacity() const;
+
+private:
+
+	template <size_t... I>
+	ConstReference reference(size_t position, std::index_sequence<I...>) const;
+	template <size_t... I>
+	Reference reference(size_t position, std::index_sequence<I...>);
+	template <size_t... I>
+	void assign(size_t position, const std::tuple<Fields...>& element, std::index_sequence<I...>);
+	template <size_t... I>
+	void reserveColumns(size_t newCapacity, std::index_sequence<I...>);
+	template <size_t... I>
+	size_t minCapacity(std::index_sequence<I...>) const;
+	template <class S, size_t... I>
+	S makeElement(size_t position, std::index_sequence<I...>) const;
+
+	//! Copies the data of other object
+	void copy(const SoaArray& other);
+
+
+	// Class members:
+
+	std::tuple<Container<Fields>...> columns;
+	size_t size; //!< Number of elements stored in the array
+};
+
+#include "SoaArray.ipp"
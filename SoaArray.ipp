@@ -0,0 +1,228 @@
+#include "SoaArray.h"
+#include <algorithm>
+
+template<class... Fields>
+inline SoaArray<Fields...>::SoaArray() : columns(), size(0)
+{
+}
+
+template<class... Fields>
+inline SoaArray<Fields...>::SoaArray(size_t capacity) : columns(), size(0)
+{
+	reserve(capacity);
+}
+
+template<class... Fields>
+inline SoaArray<Fields...>::SoaArray(const SoaArray& other) : columns(), size(0)
+{
+	copy(other);
+}
+
+template<class... Fields>
+inline SoaArray<Fields...>& SoaArray<Fields...>::operator=(const SoaArray& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+template<class... Fields>
+inline typename SoaArray<Fields...>::ConstReference SoaArray<Fields...>::operator[](size_t position) const
+{
+	return reference(position, Indices());
+}
+
+template<class... Fields>
+inline typename SoaArray<Fields...>::Reference SoaArray<Fields...>::operator[](size_t position)
+{
+	return reference(position, Indices());
+}
+
+template<class... Fields>
+inline typename SoaArray<Fields...>::ConstReference SoaArray<Fields...>::at(size_t position) const
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return reference(position, Indices());
+}
+
+template<class... Fields>
+inline typename SoaArray<Fields...>::Reference SoaArray<Fields...>::at(size_t position)
+{
+	if (size <= position)
+		throw std::out_of_range("Out of range\n");
+
+	return reference(position, Indices());
+}
+
+template<class... Fields>
+template<size_t I>
+inline const typename SoaArray<Fields...>::template Field<I>& SoaArray<Fields...>::get(size_t position) const
+{
+	return std::get<I>(columns)[position];
+}
+
+template<class... Fields>
+template<size_t I>
+inline typename SoaArray<Fields...>::template Field<I>& SoaArray<Fields...>::get(size_t position)
+{
+	return std::get<I>(columns)[position];
+}
+
+template<class... Fields>
+template<size_t I>
+inline Span<const typename SoaArray<Fields...>::template Field<I>> SoaArray<Fields...>::column() const
+{
+	return Span<const Field<I>>(std::get<I>(columns).getData(), size);
+}
+
+template<class... Fields>
+template<size_t I>
+inline Span<typename SoaArray<Fields...>::template Field<I>> SoaArray<Fields...>::column()
+{
+	return Span<Field<I>>(std::get<I>(columns).getData(), size);
+}
+
+template<class... Fields>
+inline void SoaArray<Fields...>::push_back(const Fields&... values)
+{
+	push_back(std::tuple<Fields...>(values...));
+}
+
+template<class... Fields>
+inline void SoaArray<Fields...>::push_back(const std::tuple<Fields...>& element)
+{
+	if (size == getCapacity()) {
+
+		size_t newCapacity = (size_t)(getCapacity() * RESIZE_FACTOR);
+		if (newCapacity < std::get<0>(columns).getInitCap())
+			newCapacity = std::get<0>(columns).getInitCap();
+
+		reserve(newCapacity);
+	}
+
+	assign(size, element, Indices());
+	++size;
+}
+
+template<class... Fields>
+inline void SoaArray<Fields...>::pop_back()
+{
+	if (empty())
+		throw std::logic_error("Pop from empty array\n");
+	--size;
+}
+
+template<class... Fields>
+inline void SoaArray<Fields...>::resize(size_t newSize)
+{
+	reserve(newSize);
+	size = newSize;
+}
+
+template<class... Fields>
+inline void SoaArray<Fields...>::reserve(size_t newCapacity)
+{
+	// All columns grow in the same step to at least the same capacity. The capacity of the array
+	// is the smallest of them, so every position below it exists in every column
+	if (newCapacity > getCapacity())
+		reserveColumns(newCapacity, Indices());
+}
+
+template<class... Fields>
+template<class S, class Split>
+inline SoaArray<Fields...> SoaArray<Fields...>::fromArray(const DynamicArray<S>& arr, Split split)
+{
+	SoaArray result(arr.getSize());
+	for (size_t i = 0; i < arr.getSize(); ++i)
+		result.push_back(split(arr[i]));
+
+	return result;
+}
+
+template<class... Fields>
+template<class S>
+inline DynamicArray<S> SoaArray<Fields...>::toArray() const
+{
+	DynamicArray<S> result(size);
+	for (size_t i = 0; i < size; ++i)
+		result.push_back(makeElement<S>(i, Indices()));
+
+	return result;
+}
+
+template<class... Fields>
+inline bool SoaArray<Fields...>::empty() const
+{
+	return size == 0;
+}
+
+template<class... Fields>
+inline size_t SoaArray<Fields...>::getSize() const
+{
+	return size;
+}
+
+template<class... Fields>
+inline size_t SoaArray<Fields...>::getCapacity() const
+{
+	return minCapacity(Indices());
+}
+
+template<class... Fields>
+template<size_t... I>
+inline typename SoaArray<Fields...>::ConstReference SoaArray<Fields...>::reference(size_t position, std::index_sequence<I...>) const
+{
+	return ConstReference(std::get<I>(columns)[position]...);
+}
+
+template<class... Fields>
+template<size_t... I>
+inline typename SoaArray<Fields...>::Reference SoaArray<Fields...>::reference(size_t position, std::index_sequence<I...>)
+{
+	return Reference(std::get<I>(columns)[position]...);
+}
+
+template<class... Fields>
+template<size_t... I>
+inline void SoaArray<Fields...>::assign(size_t position, const std::tuple<Fields...>& element, std::index_sequence<I...>)
+{
+	int expand[] = { 0, (std::get<I>(columns)[position] = std::get<I>(element), 0)... };
+	(void)expand;
+}
+
+template<class... Fields>
+template<size_t... I>
+inline size_t SoaArray<Fields...>::minCapacity(std::index_sequence<I...>) const
+{
+	size_t capacities[] = { std::get<I>(columns).getCap()... };
+	return *std::min_element(capacities, capacities + sizeof...(I));
+}
+
+template<class... Fields>
+template<size_t... I>
+inline void SoaArray<Fields...>::reserveColumns(size_t newCapacity, std::index_sequence<I...>)
+{
+	int expand[] = { 0, (std::get<I>(columns).reserve(size, newCapacity), 0)... };
+	(void)expand;
+}
+
+template<class... Fields>
+template<class S, size_t... I>
+inline S SoaArray<Fields...>::makeElement(size_t position, std::index_sequence<I...>) const
+{
+	return S{ std::get<I>(columns)[position]... };
+}
+
+template<class... Fields>
+inline void SoaArray<Fields...>::copy(const SoaArray& other)
+{
+	reserve(other.size);
+	for (size_t i = 0; i < other.size; ++i)
+		assign(i, other[i], Indices());
+
+	size = other.size;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+
+//! Non-owning view of a contiguous range of elements
+template <class T>
+class Span {
+
+public:
+
+	Span() : data(nullptr), size(0) {}
+	Span(T* data, size_t size) : data(data), size(size) {}
+
+	inline T& operator[](size_t index) const { return data[index]; }
+
+	inline T* getData() const { return data; }
+	inline size_t getSize() const { return size; }
+	inline bool empty() const { return size == 0; }
+
+	inline T* begin() const { return data; }
+	inline T* end() const { return data + size; }
+
+private:
+
+	T* data;
+	size_t size;
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "Bits.h"
+#include "Container.h"
+#include "DynamicArray.h"
+
+/**
+* \brief Array indexed by 32-bit ids, of which only a few are used
+*
+* The id space is split into pages of PAGE_SIZE consecutive ids. A page is allocated the first time
+* one of its ids is set and released when its last id is erased, so memory is proportional to the
+* number of used pages. A lookup reads the page directory and the page, without hashing.
+*/
+template <class T>
+class SparseArray
+{
+public:
+	static constexpr size_t PAGE_BITS = 12;
+	static constexpr size_t PAGE_SIZE = (size_t)1 << PAGE_BITS;
+
+	//! Default constructor
+	SparseArray();
+	//! Copy constructor
+	SparseArray(const SparseArray& other);
+	//! Destructor
+	~SparseArray();
+
+	//! Operator =
+	SparseArray& operator=(const SparseArray& other);
+
+	/**
+	* \brief Access the value of an id
+	*
+	* If the id is not set, it is set to a default constructed value
+	*/
+	T& operator[](uint32_t id);
+
+	/**
+	* \brief Access the value of an id
+	*
+	* If the id is not set, throws an out_of_range exception
+	*/
+	const T& at(uint32_t id) const;
+
+	/**
+	* \brief Access the value of an id
+	*
+	* If the id is not set, throws an out_of_range exception
+	*/
+	T& at(uint32_t id);
+
+	//! Returns a pointer to the value of the id, nullptr if it is not set
+	const T* find(uint32_t id) const;
+	//! Returns a pointer to the value of the id, nullptr if it is not set
+	T* find(uint32_t id);
+
+	//! Check if the id is set
+	bool contains(uint32_t id) const;
+
+	//! Sets the value of an id
+	void set(uint32_t id, const T& value);
+
+	/**
+	* \brief Unset an id
+	*
+	* The page of the id is released if no other id in it is set.
+	* \return True if the id was set
+	*/
+	bool erase(uint32_t id);
+
+	//! Unsets all ids and releases all pages
+	void clear();
+
+	//! Calls f(id, value) for every set id, in increasing order of ids
+	template <class F>
+	void forEach(F f) const;
+
+	/**
+	* \brief Check if the array is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return the number of set ids
+	size_t getSize() const;
+	//! Return the number of allocated pages
+	size_t getPageCount() const;
+
+private:
+
+	struct Page
+	{
+		Page() : values(PAGE_SIZE), present(), count(0) {}
+
+		bool has(size_t offset) const { return (present[offset / 64] >> (offset % 64)) & 1; }
+
+		Container<T> values;
+		uint64_t present[PAGE_SIZE / 64]; //!< Bit i is set if the id at offset i is set
+		size_t count;                     //!< Number of set ids in the page
+	};
+
+	//! Returns the page of the id, allocating it if needed
+	Page& getPage(uint32_t id);
+
+	//! Copies the data of other object
+	void copy(const SparseArray& other);
+
+
+	// Class members:
+
+	DynamicArray<Page*> pages; //!< Page directory. Only pages up to the highest used one are listed
+	size_t size;
+	size_t pageCount;
+};
+
+#include "SparseArray.ipp"
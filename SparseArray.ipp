@@ -0,0 +1,205 @@
+#include "SparseArray.h"
+
+template<class T>
+inline SparseArray<T>::SparseArray() : pages(), size(0), pageCount(0)
+{
+}
+
+template<class T>
+inline SparseArray<T>::SparseArray(const SparseArray& other) : SparseArray()
+{
+	copy(other);
+}
+
+template<class T>
+inline SparseArray<T>::~SparseArray()
+{
+	clear();
+}
+
+template<class T>
+inline SparseArray<T>& SparseArray<T>::operator=(const SparseArray& other)
+{
+	if (this != &other) {
+		copy(other);
+	}
+
+	return *this;
+}
+
+template<class T>
+inline T& SparseArray<T>::operator[](uint32_t id)
+{
+	T* value = find(id);
+	if (value)
+		return *value;
+
+	set(id, T());
+	return *find(id);
+}
+
+template<class T>
+inline const T& SparseArray<T>::at(uint32_t id) const
+{
+	const T* value = find(id);
+	if (!value)
+		throw std::out_of_range("Id is not set\n");
+
+	return *value;
+}
+
+template<class T>
+inline T& SparseArray<T>::at(uint32_t id)
+{
+	return const_cast<T&>(const_cast<const SparseArray&>(*this).at(id));
+}
+
+template<class T>
+inline const T* SparseArray<T>::find(uint32_t id) const
+{
+	size_t pageIndex = id >> PAGE_BITS;
+	if (pageIndex >= pages.getSize() || !pages[pageIndex])
+		return nullptr;
+
+	const Page& page = *pages[pageIndex];
+	size_t offset = id & (PAGE_SIZE - 1);
+	return page.has(offset) ? &page.values[offset] : nullptr;
+}
+
+template<class T>
+inline T* SparseArray<T>::find(uint32_t id)
+{
+	return const_cast<T*>(const_cast<const SparseArray&>(*this).find(id));
+}
+
+template<class T>
+inline bool SparseArray<T>::contains(uint32_t id) const
+{
+	return find(id) != nullptr;
+}
+
+template<class T>
+inline void SparseArray<T>::set(uint32_t id, const T& value)
+{
+	Page& page = getPage(id);
+	size_t offset = id & (PAGE_SIZE - 1);
+
+	if (!page.has(offset)) {
+		page.present[offset / 64] |= (uint64_t)1 << (offset % 64);
+		++page.count;
+		++size;
+	}
+	page.values[offset] = value;
+}
+
+template<class T>
+inline bool SparseArray<T>::erase(uint32_t id)
+{
+	size_t pageIndex = id >> PAGE_BITS;
+	size_t offset = id & (PAGE_SIZE - 1);
+	if (pageIndex >= pages.getSize() || !pages[pageIndex] || !pages[pageIndex]->has(offset))
+		return false;
+
+	Page* page = pages[pageIndex];
+	page->present[offset / 64] &= ~((uint64_t)1 << (offset % 64));
+	--size;
+
+	if (--page->count == 0) {
+		delete page;
+		pages[pageIndex] = nullptr;
+		--pageCount;
+
+		while (!pages.empty() && !pages.back())
+			pages.pop_back();
+	}
+
+	return true;
+}
+
+template<class T>
+inline void SparseArray<T>::clear()
+{
+	for (size_t i = 0; i < pages.getSize(); ++i)
+		delete pages[i];
+
+	pages.resize(0);
+	size = 0;
+	pageCount = 0;
+}
+
+template<class T>
+template<class F>
+inline void SparseArray<T>::forEach(F f) const
+{
+	for (size_t i = 0; i < pages.getSize(); ++i) {
+		const Page* page = pages[i];
+		if (!page)
+			continue;
+
+		for (size_t word = 0; word < PAGE_SIZE / 64; ++word) {
+			for (uint64_t bits = page->present[word]; bits != 0; bits &= bits - 1) {
+				size_t offset = word * 64 + countTrailingZeros(bits);
+				f((uint32_t)((i << PAGE_BITS) + offset), page->values[offset]);
+			}
+		}
+	}
+}
+
+template<class T>
+inline bool SparseArray<T>::empty() const
+{
+	return size == 0;
+}
+
+template<class T>
+inline size_t SparseArray<T>::getSize() const
+{
+	return size;
+}
+
+template<class T>
+inline size_t SparseArray<T>::getPageCount() const
+{
+	return pageCount;
+}
+
+template<class T>
+inline typename SparseArray<T>::Page& SparseArray<T>::getPage(uint32_t id)
+{
+	size_t pageIndex = id >> PAGE_BITS;
+	while (pages.getSize() <= pageIndex)
+		pages.push_back(nullptr);
+
+	if (!pages[pageIndex]) {
+		pages[pageIndex] = new Page();
+		++pageCount;
+	}
+
+	return *pages[pageIndex];
+}
+
+template<class T>
+inline void SparseArray<T>::copy(const SparseArray& other)
+{
+	clear();
+
+	for (size_t i = 0; i < other.pages.getSize(); ++i) {
+		pages.push_back(nullptr);
+		const Page* source = other.pages[i];
+		if (!source)
+			continue;
+
+		Page* page = new Page();
+		for (size_t word = 0; word < PAGE_SIZE / 64; ++word)
+			page->present[word] = source->present[word];
+		for (size_t offset = 0; offset < PAGE_SIZE; ++offset) {
+			if (source->has(offset))
+				page->values[offset] = source->values[offset];
+		}
+		page->count = source->count;
+		pages[i] = page;
+	}
+
+	size = other.size;
+	pageCount = other.pageCount;
+}
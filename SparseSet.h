@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "DynamicArray.h"
+#include "SparseArray.h"
+
+/**
+* \brief Map from 32-bit ids to values, packed for iteration
+*
+* The values and their ids are kept in two dense arrays. A paged sparse array maps every id to its
+* position in them, so lookups take O(1) time without hashing and iterating is a linear scan.
+* Erasing moves the last entry into the hole, so the order of the entries is not preserved.
+*/
+template <class T>
+class SparseSet
+{
+public:
+
+	//! Default constructor
+	SparseSet();
+
+	/**
+	* \brief Access the value of an id
+	*
+	* If the id is missing, it is inserted with a default constructed value
+	*/
+	T& operator[](uint32_t id);
+
+	/**
+	* \brief Access the value of an id
+	*
+	* If the id is missing, throws an out_of_range exception
+	*/
+	const T& at(uint32_t id) const;
+
+	/**
+	* \brief Access the value of an id
+	*
+	* If the id is missing, throws an out_of_range exception
+	*/
+	T& at(uint32_t id);
+
+	//! Returns a pointer to the value of the id, nullptr if it is missing
+	const T* find(uint32_t id) const;
+	//! Returns a pointer to the value of the id, nullptr if it is missing
+	T* find(uint32_t id);
+
+	//! Check if the id is in the set
+	bool contains(uint32_t id) const;
+
+	/**
+	* \brief Add an entry
+	*
+	* \return True if the entry was added
+	* \return False if the id was already in the set. Its value is not changed
+	*/
+	bool insert(uint32_t id, const T& value);
+
+	/**
+	* \brief Remove an entry
+	*
+	* The last entry is moved to its position.
+	* \return True if the entry was removed
+	* \return False if the id was not in the set
+	*/
+	bool erase(uint32_t id);
+
+	//! Return the packed array of ids
+	const DynamicArray<uint32_t>& getIds() const;
+	//! Return the packed array of values. The value at position i belongs to the id at position i
+	const DynamicArray<T>& getValues() const;
+
+	/**
+	* \brief Check if the set is empty
+	*
+	*  \return True if size = 0
+	*  \return False if size != 0
+	*/
+	bool empty() const;
+
+	//! Return the number of entries
+	size_t getSize() const;
+	//! Return the number of pages allocated by the sparse index
+	size_t getPageCount() const;
+
+private:
+
+	// Class members:
+
+	DynamicArray<uint32_t> ids;
+	DynamicArray<T> values;
+	SparseArray<uint32_t> positions; //!< Position of every id in the dense arrays
+};
+
+#include "SparseSet.ipp"
@@ -0,0 +1,115 @@
+#include "SparseSet.h"
+
+template<class T>
+inline SparseSet<T>::SparseSet() : ids(), values(), positions()
+{
+}
+
+template<class T>
+inline T& SparseSet<T>::operator[](uint32_t id)
+{
+	T* value = find(id);
+	if (value)
+		return *value;
+
+	insert(id, T());
+	return values.back();
+}
+
+template<class T>
+inline const T& SparseSet<T>::at(uint32_t id) const
+{
+	const T* value = find(id);
+	if (!value)
+		throw std::out_of_range("Id not found\n");
+
+	return *value;
+}
+
+template<class T>
+inline T& SparseSet<T>::at(uint32_t id)
+{
+	return const_cast<T&>(const_cast<const SparseSet&>(*this).at(id));
+}
+
+template<class T>
+inline const T* SparseSet<T>::find(uint32_t id) const
+{
+	const uint32_t* position = positions.find(id);
+	return position ? &values[*position] : nullptr;
+}
+
+template<class T>
+inline T* SparseSet<T>::find(uint32_t id)
+{
+	return const_cast<T*>(const_cast<const SparseSet&>(*this).find(id));
+}
+
+template<class T>
+inline bool SparseSet<T>::contains(uint32_t id) const
+{
+	return positions.contains(id);
+}
+
+template<class T>
+inline bool SparseSet<T>::insert(uint32_t id, const T& value)
+{
+	if (positions.contains(id))
+		return false;
+
+	positions.set(id, (uint32_t)ids.getSize());
+	ids.push_back(id);
+	values.push_back(value);
+	return true;
+}
+
+template<class T>
+inline bool SparseSet<T>::erase(uint32_t id)
+{
+	const uint32_t* found = positions.find(id);
+	if (!found)
+		return false;
+
+	uint32_t position = *found;
+	size_t last = ids.getSize() - 1;
+	if (position != last) {
+		ids[position] = ids[last];
+		values[position] = values[last];
+		positions.set(ids[position], position);
+	}
+	ids.pop_back();
+	values.pop_back();
+	positions.erase(id);
+
+	return true;
+}
+
+template<class T>
+inline const DynamicArray<uint32_t>& SparseSet<T>::getIds() const
+{
+	return ids;
+}
+
+template<class T>
+inline const DynamicArray<T>& SparseSet<T>::getValues() const
+{
+	return values;
+}
+
+template<class T>
+inline bool SparseSet<T>::empty() const
+{
+	return ids.empty();
+}
+
+template<class T>
+inline size_t SparseSet<T>::getSize() const
+{
+	return ids.getSize();
+}
+
+template<class T>
+inline size_t SparseSet<T>::getPageCount() const
+{
+	return positions.getPageCount();
+}
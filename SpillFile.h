@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPILL_FILE_POSIX
+#else
+#include <mutex>
+#endif
+
+/**
+* \brief Anonymous temporary file for data which does not fit in memory
+*
+* The file is created with std::tmpfile(), so it is removed when closed, also if the process dies.
+* Reads and writes take an explicit offset. Transfers to distinct ranges may run from several
+* threads at once. Failures throw a runtime_error exception.
+*/
+class SpillFile
+{
+public:
+
+	//! Creates the file
+	SpillFile();
+	SpillFile(const SpillFile&) = delete;
+	SpillFile& operator=(const SpillFile&) = delete;
+	//! Closes and removes the file
+	~SpillFile();
+
+	//! Writes bytes at the given offset, extending the file if needed
+	void write(const void* source, size_t bytes, uint64_t offset);
+
+	//! Reads bytes from the given offset. Reading past the end of the file throws
+	void read(void* target, size_t bytes, uint64_t offset);
+
+private:
+
+	// Class members:
+
+	std::FILE* file;
+#ifndef SPILL_FILE_POSIX
+	std::mutex lock; //!< stdio keeps one position per file
+#endif
+};
+
+#include "SpillFile.ipp"
@@ -0,0 +1,69 @@
+#include "SpillFile.h"
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#ifdef SPILL_FILE_POSIX
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+inline SpillFile::SpillFile()
+	: file(std::tmpfile())
+{
+	if (!file)
+		throw std::runtime_error("Cannot create a temporary file\n");
+}
+
+inline SpillFile::~SpillFile()
+{
+	std::fclose(file);
+}
+
+inline void SpillFile::write(const void* source, size_t bytes, uint64_t offset)
+{
+	const char* from = (const char*)source;
+
+#ifdef SPILL_FILE_POSIX
+	int fd = fileno(file);
+	while (bytes > 0) {
+		ssize_t done = pwrite(fd, from, bytes, (off_t)offset);
+		if (done < 0 && errno == EINTR)
+			continue;
+		if (done <= 0)
+			throw std::runtime_error(std::string("Cannot write the temporary file: ") + std::strerror(errno) + "\n");
+		from += done;
+		bytes -= done;
+		offset += done;
+	}
+#else
+	std::lock_guard<std::mutex> guard(lock);
+	if (_fseeki64(file, (long long)offset, SEEK_SET) != 0 || std::fwrite(from, 1, bytes, file) != bytes)
+		throw std::runtime_error("Cannot write the temporary file\n");
+#endif
+}
+
+inline void SpillFile::read(void* target, size_t bytes, uint64_t offset)
+{
+	char* to = (char*)target;
+
+#ifdef SPILL_FILE_POSIX
+	int fd = fileno(file);
+	while (bytes > 0) {
+		ssize_t done = pread(fd, to, bytes, (off_t)offset);
+		if (done < 0 && errno == EINTR)
+			continue;
+		if (done < 0)
+			throw std::runtime_error(std::string("Cannot read the temporary file: ") + std::strerror(errno) + "\n");
+		if (done == 0)
+			throw std::runtime_error("Read past the end of the temporary file\n");
+		to += done;
+		bytes -= done;
+		offset += done;
+	}
+#else
+	std::lock_guard<std::mutex> guard(lock);
+	if (_fseeki64(file, (long long)offset, SEEK_SET) != 0 || std::fread(to, 1, bytes, file) != bytes)
+		throw std::runtime_error("Cannot read the temporary file\n");
+#endif
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STREAMING_STORE_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+* Bulk fill and copy with non-temporal stores.
+*
+* Writing a buffer larger than the last level cache through the cache evicts everything else and
+* gains nothing, because the first lines are evicted again before the buffer is read. Streaming
+* stores write whole lines directly to memory instead. They are used for trivially copyable types
+* in ranges of at least STREAMING_THRESHOLD bytes, on processors with SSE2.
+*/
+
+#ifdef DYNAMIC_ARRAY_STREAMING_THRESHOLD
+static constexpr size_t STREAMING_THRESHOLD = DYNAMIC_ARRAY_STREAMING_THRESHOLD;
+#else
+//! Ranges of at least that many bytes are written with streaming stores. Larger than common last level caches
+static constexpr size_t STREAMING_THRESHOLD = (size_t)32 << 20;
+#endif
+
+//! Check if a range of the given size is written with streaming stores
+inline bool isStreamingRange(size_t bytes)
+{
+	return bytes >= STREAMING_THRESHOLD;
+}
+
+//! Copies bytes with streaming stores. The stores are ordered by a fence before returning
+inline void streamCopy(void* target, const void* source, size_t bytes)
+{
+#ifdef STREAMING_STORE_SSE2
+	char* to = (char*)target;
+	const char* from = (const char*)source;
+
+	size_t head = (16 - (uintptr_t)to % 16) % 16;
+	if (head > bytes)
+		head = bytes;
+	std::memcpy(to, from, head);
+	to += head;
+	from += head;
+	bytes -= head;
+
+	for (; bytes >= 16; bytes -= 16, to += 16, from += 16)
+		_mm_stream_si128((__m128i*)to, _mm_loadu_si128((const __m128i*)from));
+
+	std::memcpy(to, from, bytes);
+	_mm_sfence();
+#else
+	std::memcpy(target, source, bytes);
+#endif
+}
+
+//! Sets count elements to value with streaming stores where the size of T allows it
+template <class T>
+inline void streamFill(T* target, size_t count, const T& value)
+{
+#ifdef STREAMING_STORE_SSE2
+	// A 16 byte store must hold whole copies of the value and start at an element
+	if (16 % sizeof(T) == 0 && (uintptr_t)target % sizeof(T) == 0) {
+		size_t i = 0;
+		for (; i < count && (uintptr_t)(target + i) % 16 != 0; ++i)
+			target[i] = value;
+
+		unsigned char pattern[16];
+		for (size_t k = 0; k < 16 / sizeof(T); ++k)
+			std::memcpy(pattern + k * sizeof(T), &value, sizeof(T));
+		__m128i line = _mm_loadu_si128((const __m128i*)pattern);
+
+		size_t perStore = 16 / sizeof(T);
+		for (; i + perStore <= count; i += perStore)
+			_mm_stream_si128((__m128i*)(target + i), line);
+
+		for (; i < count; ++i)
+			target[i] = value;
+
+		_mm_sfence();
+		return;
+	}
+#endif
+	for (size_t i = 0; i < count; ++i)
+		target[i] = value;
+}
+
+//! Copies count elements. Uses streaming stores if requested and T is trivially copyable
+template <class T>
+inline void copyElements(T* target, const T* source, size_t count, bool streaming)
+{
+	if (streaming && std::is_trivially_copyable<T>::value) {
+		streamCopy(target, source, count * sizeof(T));
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+		target[i] = source[i];
+}
+
+//! Sets count elements to value. Uses streaming stores if requested and T is trivially copyable
+template <class T>
+inline void fillElements(T* target, size_t count, const T& value, bool streaming)
+{
+	if (streaming && std::is_trivially_copyable<T>::value) {
+		streamFill(target, count, value);
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+		target[i] = value;
+}
@@ -1,8 +1,34 @@
 #define CATCH_CONFIG_MAIN
 
 #include "catch.hpp"
+#include "AsyncFile.h"
+#include "BitArray.h"
+#include "CompressedIntArray.h"
+#include "DoubleEndedArray.h"
 #include "DynamicArray.h"
+#include "EytzingerIndex.h"
+#include "ExternalArray.h"
+#include "ExternalSort.h"
+#include "FlatHashMap.h"
+#include "FlatMap.h"
+#include "FlatSet.h"
+#include "InplaceArray.h"
+#include "PackedIntArray.h"
+#include "PersistentArray.h"
+#include "RingArray.h"
+#include "SlotMap.h"
+#include "SnapshotArray.h"
+#include "SoaArray.h"
+#include "SparseArray.h"
+#include "SparseSet.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 void requireSameContents(DynamicArray<int>& dArr, std::vector<int> expected)
@@ -297,4 +323,1794 @@ TEST_CASE("Test Access methods") {
 
 		REQUIRE(dArr.back() == expected.back());
 	}
-}
\ No newline at end of file
+}
+
+template <class Array>
+void requireSameElements(const Array& arr, const std::vector<int>& expected)
+{
+	REQUIRE(arr.getSize() == expected.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+		REQUIRE(arr[i] == expected[i]);
+}
+
+TEST_CASE("PersistentArray keeps the old versions unchanged")
+{
+	PersistentArray<int> empty;
+	PersistentArray<int> one = empty.push_back(1);
+	PersistentArray<int> two = one.push_back(2);
+	PersistentArray<int> changed = two.set(0, 10);
+
+	REQUIRE(empty.empty() == true);
+	requireSameElements(one, { 1 });
+	requireSameElements(two, { 1, 2 });
+	requireSameElements(changed, { 10, 2 });
+
+	REQUIRE_THROWS_AS(two.at(2), std::out_of_range);
+	REQUIRE_THROWS_AS(two.set(2, 0), std::out_of_range);
+}
+
+TEST_CASE("PersistentArray::push_back() and set() on a multi-level tree")
+{
+	PersistentArray<int> arr;
+	std::vector<int> expected;
+	for (int i = 0; i < 40000; ++i) {
+		arr = arr.push_back(i);
+		expected.push_back(i);
+	}
+	requireSameElements(arr, expected);
+
+	PersistentArray<int> changed = arr;
+	for (size_t i = 0; i < expected.size(); i += 97)
+		changed = changed.set(i, -1);
+
+	for (size_t i = 0; i < expected.size(); ++i) {
+		REQUIRE(arr[i] == expected[i]);
+		REQUIRE(changed[i] == (i % 97 == 0 ? -1 : expected[i]));
+	}
+}
+
+TEST_CASE("PersistentArray::slice() and concat()")
+{
+	std::vector<int> expected;
+	DynamicArray<int> dArr;
+	for (int i = 0; i < 5000; ++i) {
+		dArr.push_back(i);
+		expected.push_back(i);
+	}
+	PersistentArray<int> arr(dArr);
+
+	SECTION("slice() returns the elements in the range")
+	{
+		requireSameElements(arr.slice(0, 5000), expected);
+		requireSameElements(arr.slice(33, 1057), std::vector<int>(expected.begin() + 33, expected.begin() + 1057));
+		requireSameElements(arr.slice(4999, 5000), { 4999 });
+		REQUIRE(arr.slice(10, 10).empty() == true);
+		REQUIRE_THROWS_AS(arr.slice(10, 5001), std::out_of_range);
+	}
+
+	SECTION("concat() of arrays with different heights keeps all elements in order")
+	{
+		std::vector<int> concatenated;
+		PersistentArray<int> result;
+		size_t lengths[] = { 1, 31, 33, 1000, 7, 4000, 2, 1024, 500 };
+		size_t from = 0;
+
+		for (size_t length : lengths) {
+			PersistentArray<int> part = arr.slice(from, from + length);
+			result = result.concat(part);
+			concatenated.insert(concatenated.end(), expected.begin() + from, expected.begin() + from + length);
+			from = (from + 577) % 900;
+		}
+		requireSameElements(result, concatenated);
+
+		result = result.push_back(-5).set(3, -3);
+		concatenated.push_back(-5);
+		concatenated[3] = -3;
+		requireSameElements(result, concatenated);
+		requireSameElements(result.slice(100, 6000), std::vector<int>(concatenated.begin() + 100, concatenated.begin() + 6000));
+	}
+
+	SECTION("Repeated concat() of small arrays")
+	{
+		PersistentArray<int> result;
+		std::vector<int> concatenated;
+		for (int i = 0; i < 3000; ++i) {
+			result = result.concat(PersistentArray<int>{ i, -i, i });
+			concatenated.insert(concatenated.end(), { i, -i, i });
+		}
+		requireSameElements(result, concatenated);
+	}
+}
+
+TEST_CASE("PersistentArray::Transient builds in place and leaves the source unchanged")
+{
+	PersistentArray<int> original{ 1, 2, 3 };
+	PersistentArray<int>::Transient builder = original.transient();
+	std::vector<int> expected{ 1, 2, 3 };
+
+	for (int i = 0; i < 2000; ++i) {
+		builder.push_back(i);
+		expected.push_back(i);
+	}
+	builder.set(0, 100);
+	expected[0] = 100;
+
+	PersistentArray<int> built = builder.persistent();
+	builder.set(1, 200);
+
+	requireSameElements(original, { 1, 2, 3 });
+	requireSameElements(built, expected);
+
+	DynamicArray<int> converted = built.toDynamicArray();
+	REQUIRE(converted.getSize() == expected.size());
+	requireSameContents(converted, expected);
+}
+
+static_assert(!std::is_copy_constructible<PersistentArray<int>::Transient>::value, "Copies would change the same nodes");
+static_assert(!std::is_copy_assignable<PersistentArray<int>::Transient>::value, "Copies would change the same nodes");
+
+TEST_CASE("PersistentArray::Transient moves leave the source empty")
+{
+	PersistentArray<int> original{ 1, 2, 3 };
+	PersistentArray<int>::Transient builder = original.transient();
+	builder.push_back(4);
+
+	PersistentArray<int>::Transient moved(std::move(builder));
+	REQUIRE(builder.getSize() == 0);
+	builder.push_back(7);
+	moved.set(0, 100);
+
+	PersistentArray<int>::Transient assigned = PersistentArray<int>().transient();
+	assigned = std::move(moved);
+	REQUIRE(moved.getSize() == 0);
+	assigned.push_back(5);
+
+	requireSameElements(original, { 1, 2, 3 });
+	requireSameElements(builder.persistent(), { 7 });
+	requireSameElements(assigned.persistent(), { 100, 2, 3, 4, 5 });
+}
+
+TEST_CASE("SnapshotArray snapshots are not affected by the writer")
+{
+	SnapshotArray<int> arr;
+	arr.push_back(1);
+	arr.push_back(2);
+
+	SnapshotArray<int>::Snapshot first = arr.snapshot();
+
+	for (int i = 3; i <= 100; ++i)
+		arr.push_back(i);
+
+	SECTION("Old snapshot keeps its size and elements after reallocations")
+	{
+		REQUIRE(first.getSize() == 2);
+		REQUIRE(first[0] == 1);
+		REQUIRE(first[1] == 2);
+		REQUIRE_THROWS_AS(first.at(2), std::out_of_range);
+	}
+
+	SECTION("New snapshot sees all elements")
+	{
+		SnapshotArray<int>::Snapshot second = arr.snapshot();
+		REQUIRE(second.getSize() == 100);
+		for (size_t i = 0; i < second.getSize(); ++i)
+			REQUIRE(second[i] == (int)i + 1);
+	}
+
+	SECTION("Retired buffers are kept while an old snapshot exists and freed after it is released")
+	{
+		REQUIRE(arr.getRetiredCount() > 0);
+
+		SnapshotArray<int>::Snapshot moved(std::move(first));
+		arr.reclaim();
+		REQUIRE(arr.getRetiredCount() > 0);
+		REQUIRE(moved[1] == 2);
+	}
+}
+
+TEST_CASE("SnapshotArray readers see consistent snapshots while the writer appends")
+{
+	const int count = 20000;
+	SnapshotArray<int> arr;
+	std::atomic<bool> done(false);
+	std::atomic<bool> consistent(true);
+
+	auto reader = [&]() {
+		while (!done.load()) {
+			SnapshotArray<int>::Snapshot snapshot = arr.snapshot();
+			for (size_t i = 0; i < snapshot.getSize(); ++i) {
+				if (snapshot[i] != (int)i)
+					consistent = false;
+			}
+		}
+	};
+
+	std::thread readers[4] = { std::thread(reader), std::thread(reader), std::thread(reader), std::thread(reader) };
+
+	for (int i = 0; i < count; ++i)
+		arr.push_back(i);
+
+	done = true;
+	for (std::thread& t : readers)
+		t.join();
+
+	arr.reclaim();
+	REQUIRE(consistent.load() == true);
+	REQUIRE(arr.getSize() == count);
+	REQUIRE(arr.getRetiredCount() == 0);
+}
+
+TEST_CASE("RingArray operations on both ends")
+{
+	RingArray<int> ring;
+
+	SECTION("Default constructed ring is empty and pops throw exceptions")
+	{
+		REQUIRE(ring.empty() == true);
+		REQUIRE(ring.getCapacity() == 0);
+		REQUIRE_THROWS_AS(ring.pop_front(), std::logic_error);
+		REQUIRE_THROWS_AS(ring.pop_back(), std::logic_error);
+	}
+
+	SECTION("push_front() and push_back() keep the order and the capacity is a power of two")
+	{
+		std::vector<int> expected;
+		for (int i = 0; i < 10; ++i) {
+			ring.push_back(i);
+			ring.push_front(-i);
+			expected.push_back(i);
+			expected.insert(expected.begin(), -i);
+		}
+
+		requireSameElements(ring, expected);
+		REQUIRE(ring.getCapacity() == 32);
+		REQUIRE(ring.front() == -9);
+		REQUIRE(ring.back() == 9);
+		REQUIRE_THROWS_AS(ring.at(20), std::out_of_range);
+	}
+
+	SECTION("Used as a FIFO the ring wraps around without growing")
+	{
+		for (int i = 0; i < 4; ++i)
+			ring.push_back(i);
+
+		for (int i = 4; i < 100; ++i) {
+			REQUIRE(ring.front() == i - 4);
+			ring.pop_front();
+			ring.push_back(i);
+		}
+
+		REQUIRE(ring.getCapacity() == 4);
+		requireSameElements(ring, { 96, 97, 98, 99 });
+	}
+}
+
+TEST_CASE("RingArray spans and growth of a wrapped ring")
+{
+	RingArray<int> ring(8);
+	for (int i = 0; i < 8; ++i)
+		ring.push_back(i);
+	for (int i = 0; i < 5; ++i) {
+		ring.pop_front();
+		ring.push_back(8 + i);
+	}
+
+	SECTION("The two spans cover all elements in order")
+	{
+		Span<int> first = ring.getFirstSpan();
+		Span<int> second = ring.getSecondSpan();
+		REQUIRE(first.getSize() == 3);
+		REQUIRE(second.getSize() == 5);
+		REQUIRE(first[0] == 5);
+		REQUIRE(second[0] == 8);
+		REQUIRE(second[4] == 12);
+	}
+
+	SECTION("Growth unrolls the ring to the beginning of the new buffer")
+	{
+		ring.push_back(13);
+		REQUIRE(ring.getCapacity() == 16);
+		REQUIRE(ring.getFirstSpan().getSize() == 9);
+		REQUIRE(ring.getSecondSpan().empty() == true);
+		requireSameElements(ring, { 5, 6, 7, 8, 9, 10, 11, 12, 13 });
+	}
+
+	SECTION("Copy keeps the logical order")
+	{
+		RingArray<int> copy(ring);
+		RingArray<int> assigned{ 1 };
+		assigned = ring;
+		requireSameElements(copy, { 5, 6, 7, 8, 9, 10, 11, 12 });
+		requireSameElements(assigned, { 5, 6, 7, 8, 9, 10, 11, 12 });
+	}
+}
+
+TEST_CASE("DoubleEndedArray operations on both ends")
+{
+	DoubleEndedArray<int> dArr;
+	std::vector<int> expected;
+
+	SECTION("pop_front() and pop_back() on empty array throw exceptions")
+	{
+		REQUIRE_THROWS_AS(dArr.pop_front(), std::logic_error);
+		REQUIRE_THROWS_AS(dArr.pop_back(), std::logic_error);
+	}
+
+	SECTION("push_front() on empty array puts the free space on the front")
+	{
+		dArr.push_front(1);
+		REQUIRE(dArr.getCapacity() == dArr.getFrontSlack() + 1);
+		REQUIRE(dArr.getBackSlack() == 0);
+	}
+
+	SECTION("Mixed pushes keep the elements contiguous and in order")
+	{
+		for (int i = 0; i < 100; ++i) {
+			dArr.push_front(-i);
+			expected.insert(expected.begin(), -i);
+			if (i % 3 == 0) {
+				dArr.push_back(i);
+				expected.push_back(i);
+			}
+		}
+
+		requireSameElements(dArr, expected);
+		REQUIRE(dArr.getData() == &dArr.front());
+		REQUIRE(dArr.getFrontSlack() + dArr.getSize() + dArr.getBackSlack() == dArr.getCapacity());
+		REQUIRE_THROWS_AS(dArr.at(expected.size()), std::out_of_range);
+	}
+
+	SECTION("Used as a queue the array recenters instead of growing")
+	{
+		size_t capacity = 0;
+		for (int i = 0; i < 8; ++i)
+			dArr.push_back(i);
+
+		for (int i = 8; i < 1000; ++i) {
+			REQUIRE(dArr.front() == i - 8);
+			dArr.pop_front();
+			dArr.push_back(i);
+
+			if (i == 100)
+				capacity = dArr.getCapacity();
+		}
+
+		REQUIRE(dArr.getCapacity() == capacity);
+		REQUIRE(capacity < 8 * 4);
+		REQUIRE(dArr.back() == 999);
+	}
+}
+
+TEST_CASE("DoubleEndedArray copy and reserve")
+{
+	DoubleEndedArray<int> dArr{ 3, 4 };
+	dArr.push_front(2);
+	dArr.push_front(1);
+
+	SECTION("reserve() keeps the front slack and the elements")
+	{
+		size_t frontSlack = dArr.getFrontSlack();
+		dArr.reserve(50);
+		REQUIRE(dArr.getCapacity() == 50);
+		REQUIRE(dArr.getFrontSlack() == frontSlack);
+		requireSameElements(dArr, { 1, 2, 3, 4 });
+	}
+
+	SECTION("Copies contain the same elements")
+	{
+		DoubleEndedArray<int> copy(dArr);
+		DoubleEndedArray<int> assigned;
+		assigned = dArr;
+		requireSameElements(copy, { 1, 2, 3, 4 });
+		requireSameElements(assigned, { 1, 2, 3, 4 });
+	}
+}
+
+struct Particle
+{
+	float x;
+	float y;
+	int id;
+};
+
+TEST_CASE("SoaArray stores every field in its own column")
+{
+	SoaArray<float, float, int> particles;
+	for (int i = 0; i < 10; ++i)
+		particles.push_back(i * 1.0f, i * 2.0f, i);
+
+	SECTION("All columns share the size and the capacity")
+	{
+		REQUIRE(particles.getSize() == 10);
+		REQUIRE(particles.column<0>().getSize() == 10);
+		REQUIRE(particles.column<2>().getSize() == 10);
+		REQUIRE(particles.getCapacity() >= 10);
+	}
+
+	SECTION("Columns are contiguous")
+	{
+		Span<int> ids = particles.column<2>();
+		for (size_t i = 0; i < ids.getSize(); ++i) {
+			REQUIRE(ids[i] == (int)i);
+			REQUIRE(&ids[i] == &particles.get<2>(i));
+		}
+	}
+
+	SECTION("Proxy references read and write the fields")
+	{
+		REQUIRE(std::get<1>(particles[3]) == 6.0f);
+
+		particles[3] = std::make_tuple(-1.0f, -2.0f, -3);
+		std::get<2>(particles.at(4)) = 40;
+
+		REQUIRE(particles.get<0>(3) == -1.0f);
+		REQUIRE(particles.get<2>(3) == -3);
+		REQUIRE(particles.get<2>(4) == 40);
+		REQUIRE_THROWS_AS(particles.at(10), std::out_of_range);
+	}
+
+	SECTION("pop_back() and copies")
+	{
+		particles.pop_back();
+		SoaArray<float, float, int> copy(particles);
+		REQUIRE(copy.getSize() == 9);
+		REQUIRE(copy.get<1>(8) == 16.0f);
+	}
+}
+
+TEST_CASE("SoaArray conversion from and to an array of structures")
+{
+	DynamicArray<Particle> aos{ { 1.0f, 2.0f, 1 }, { 3.0f, 4.0f, 2 }, { 5.0f, 6.0f, 3 } };
+
+	SoaArray<float, float, int> soa = SoaArray<float, float, int>::fromArray(aos,
+		[](const Particle& p) { return std::make_tuple(p.x, p.y, p.id); });
+
+	REQUIRE(soa.getSize() == 3);
+	REQUIRE(soa.get<1>(1) == 4.0f);
+
+	DynamicArray<Particle> back = soa.toArray<Particle>();
+	REQUIRE(back.getSize() == 3);
+	for (size_t i = 0; i < 3; ++i) {
+		REQUIRE(back[i].x == aos[i].x);
+		REQUIRE(back[i].y == aos[i].y);
+		REQUIRE(back[i].id == aos[i].id);
+	}
+}
+
+TEST_CASE("BitArray stores and changes single bits")
+{
+	BitArray bits;
+	std::vector<bool> expected;
+	for (size_t i = 0; i < 200; ++i) {
+		bits.push_back(i % 3 == 0);
+		expected.push_back(i % 3 == 0);
+	}
+
+	SECTION("Bits are read back correctly and 64 of them share a word")
+	{
+		REQUIRE(bits.getSize() == 200);
+		REQUIRE(bits.getCapacity() % 64 == 0);
+		for (size_t i = 0; i < expected.size(); ++i)
+			REQUIRE(bits[i] == expected[i]);
+		REQUIRE_THROWS_AS(bits.at(200), std::out_of_range);
+	}
+
+	SECTION("Proxy references change the bits")
+	{
+		bits[1] = true;
+		bits.at(3) = false;
+		bits[5].flip();
+		bits[7] = bits[0];
+
+		REQUIRE(bits[1] == true);
+		REQUIRE(bits[3] == false);
+		REQUIRE(bits[5] == true);
+		REQUIRE(bits[7] == true);
+	}
+
+	SECTION("pop_back() and resize() keep the unused bits zero")
+	{
+		bits.resize(130);
+		bits.pop_back();
+		REQUIRE(bits.count() == 43);
+
+		bits.resize(300, true);
+		REQUIRE(bits.count() == 43 + 171);
+		REQUIRE(bits[129] == true);
+		REQUIRE(bits[299] == true);
+
+		REQUIRE_THROWS_AS(BitArray().pop_back(), std::logic_error);
+	}
+}
+
+TEST_CASE("BitArray word-parallel operations")
+{
+	BitArray a(150);
+	BitArray b(150);
+	a[3] = true;
+	a[64] = true;
+	a[149] = true;
+	b[64] = true;
+	b[100] = true;
+
+	SECTION("count(), find_first() and find_next()")
+	{
+		REQUIRE(a.count() == 3);
+		REQUIRE(a.find_first() == 3);
+		REQUIRE(a.find_next(3) == 64);
+		REQUIRE(a.find_next(64) == 149);
+		REQUIRE((a.find_next(149) == BitArray::npos));
+		REQUIRE((BitArray(10).find_first() == BitArray::npos));
+	}
+
+	SECTION("and, or, xor and not")
+	{
+		REQUIRE((a & b).count() == 1);
+		REQUIRE((a | b).count() == 4);
+		REQUIRE((a ^ b).count() == 3);
+		REQUIRE((~a).count() == 147);
+		REQUIRE((~a)[3] == false);
+
+		REQUIRE_THROWS_AS(a &= BitArray(10), std::invalid_argument);
+	}
+
+	SECTION("toIndices() lists the set bits")
+	{
+		DynamicArray<size_t> indices = (a | b).toIndices();
+		REQUIRE(indices.getSize() == 4);
+		REQUIRE(indices[0] == 3);
+		REQUIRE(indices[1] == 64);
+		REQUIRE(indices[2] == 100);
+		REQUIRE(indices[3] == 149);
+	}
+}
+
+TEST_CASE("PackedIntArray stores values with a fixed bit width")
+{
+	PackedIntArray packed(20);
+	std::vector<uint64_t> expected;
+	for (uint64_t i = 0; i < 1000; ++i) {
+		packed.push_back((i * 7919) % (1 << 20));
+		expected.push_back((i * 7919) % (1 << 20));
+	}
+
+	SECTION("Values crossing word boundaries are read back correctly")
+	{
+		REQUIRE(packed.getWidth() == 20);
+		REQUIRE(packed.getSize() == 1000);
+		for (size_t i = 0; i < expected.size(); ++i)
+			REQUIRE(packed.get(i) == expected[i]);
+		REQUIRE_THROWS_AS(packed.at(1000), std::out_of_range);
+	}
+
+	SECTION("set() changes only the given value")
+	{
+		packed.set(3, 12345);
+		packed.set(999, 0);
+		REQUIRE(packed.get(2) == expected[2]);
+		REQUIRE(packed.get(3) == 12345);
+		REQUIRE(packed.get(4) == expected[4]);
+		REQUIRE(packed.get(999) == 0);
+	}
+
+	SECTION("A larger value widens the array and keeps the old values")
+	{
+		packed.push_back((uint64_t)1 << 40);
+		REQUIRE(packed.getWidth() == 41);
+		REQUIRE(packed.get(1000) == (uint64_t)1 << 40);
+		for (size_t i = 0; i < expected.size(); ++i)
+			REQUIRE(packed.get(i) == expected[i]);
+
+		PackedIntArray copy(packed);
+		REQUIRE(copy.getWidth() == 41);
+		REQUIRE(copy.get(999) == expected[999]);
+	}
+
+	SECTION("decode() appends a block of values")
+	{
+		DynamicArray<uint32_t> out;
+		out.push_back(7);
+		packed.decode(13, 500, out);
+
+		REQUIRE(out.getSize() == 501);
+		REQUIRE(out[0] == 7);
+		for (size_t i = 0; i < 500; ++i)
+			REQUIRE(out[i + 1] == expected[13 + i]);
+		REQUIRE_THROWS_AS(packed.decode(900, 101, out), std::out_of_range);
+	}
+}
+
+TEST_CASE("PackedIntArray edge widths")
+{
+	PackedIntArray wide{ 1, ~(uint64_t)0, 5 };
+	REQUIRE(wide.getWidth() == 64);
+	REQUIRE(wide.get(1) == ~(uint64_t)0);
+
+	DynamicArray<uint64_t> out;
+	wide.decode(0, 3, out);
+	REQUIRE(out[1] == ~(uint64_t)0);
+	REQUIRE(out[2] == 5);
+
+	PackedIntArray narrow;
+	for (int i = 0; i < 130; ++i)
+		narrow.push_back(i % 2);
+	REQUIRE(narrow.getWidth() == 1);
+	REQUIRE(narrow.get(129) == 1);
+	REQUIRE_THROWS_AS(PackedIntArray(65), std::invalid_argument);
+}
+
+TEST_CASE("CompressedIntArray frame of reference blocks")
+{
+	CompressedIntArray arr;
+	std::vector<uint64_t> expected;
+	for (uint64_t i = 0; i < 1000; ++i) {
+		uint64_t value = 1000000000000ull + (i * 37) % 1000;
+		arr.push_back(value);
+		expected.push_back(value);
+	}
+
+	SECTION("Random access to compressed blocks and to the incomplete block")
+	{
+		REQUIRE(arr.getSize() == 1000);
+		REQUIRE(arr.getBlockCount() == 8);
+		for (size_t i = 0; i < expected.size(); ++i)
+			REQUIRE(arr.get(i) == expected[i]);
+		REQUIRE_THROWS_AS(arr.at(1000), std::out_of_range);
+	}
+
+	SECTION("Differences of up to 10 bits take much less than 8 bytes per value")
+	{
+		REQUIRE(arr.getMemoryUsage() < 1000 * sizeof(uint64_t) / 3);
+	}
+
+	SECTION("decode() returns all values in order")
+	{
+		DynamicArray<uint64_t> out;
+		arr.decode(out);
+		REQUIRE(out.getSize() == 1000);
+		for (size_t i = 0; i < expected.size(); ++i)
+			REQUIRE(out[i] == expected[i]);
+	}
+}
+
+TEST_CASE("CompressedIntArray delta encoding of sorted values")
+{
+	CompressedIntArray arr(true);
+	std::vector<uint64_t> expected;
+	uint64_t value = 1600000000000ull;
+	for (uint64_t i = 0; i < 700; ++i) {
+		value += i % 5 == 0 ? 0 : (i * 13) % 100;
+		arr.push_back(value);
+		expected.push_back(value);
+	}
+
+	for (size_t i = 0; i < expected.size(); ++i)
+		REQUIRE(arr.get(i) == expected[i]);
+
+	uint64_t block[128];
+	REQUIRE(arr.decodeBlock(2, block) == 128);
+	for (size_t i = 0; i < 128; ++i)
+		REQUIRE(block[i] == expected[256 + i]);
+	REQUIRE(arr.decodeBlock(5, block) == 700 - 5 * 128);
+
+	CompressedIntArray equal(true);
+	for (int i = 0; i < 300; ++i)
+		equal.push_back(42);
+	REQUIRE(equal.get(299) == 42);
+
+	REQUIRE_THROWS_AS(arr.push_back(0), std::invalid_argument);
+}
+
+TEST_CASE("FlatSet keeps the keys sorted and unique")
+{
+	FlatSet<int> set{ 5, 1, 9, 5, 3 };
+
+	SECTION("Initializer list keys are sorted and repeated keys are dropped")
+	{
+		requireSameElements(set, { 1, 3, 5, 9 });
+	}
+
+	SECTION("Single insert() and erase()")
+	{
+		REQUIRE(set.insert(4) == true);
+		REQUIRE(set.insert(4) == false);
+		REQUIRE(set.insert(0) == true);
+		REQUIRE(set.insert(10) == true);
+		REQUIRE(set.erase(5) == true);
+		REQUIRE(set.erase(5) == false);
+		requireSameElements(set, { 0, 1, 3, 4, 9, 10 });
+	}
+
+	SECTION("Batch insert() merges once and counts only the new keys")
+	{
+		REQUIRE(set.insert(DynamicArray<int>{ 8, 2, 3, 8, 11 }) == 3);
+		requireSameElements(set, { 1, 2, 3, 5, 8, 9, 11 });
+	}
+
+	SECTION("Batch erase() compacts in one pass")
+	{
+		REQUIRE(set.erase(DynamicArray<int>{ 9, 7, 1 }) == 2);
+		requireSameElements(set, { 3, 5 });
+	}
+
+	SECTION("Searches")
+	{
+		REQUIRE(set.lower_bound(4) == 2);
+		REQUIRE(set.lower_bound(5) == 2);
+		REQUIRE(set.upper_bound(5) == 3);
+		REQUIRE(set.lower_bound(100) == 4);
+		REQUIRE(set.find(9) == 3);
+		REQUIRE((set.find(2) == FlatSet<int>::npos));
+		REQUIRE(set.contains(1) == true);
+		REQUIRE(FlatSet<int>().contains(1) == false);
+	}
+}
+
+TEST_CASE("branchlessLowerBound() matches std::lower_bound()")
+{
+	std::vector<int> sorted;
+	for (int i = 0; i < 100; ++i)
+		sorted.push_back(i / 3 * 2);
+
+	for (size_t size = 0; size <= sorted.size(); size += 7) {
+		for (int key = -1; key < 70; ++key) {
+			size_t expected = std::lower_bound(sorted.begin(), sorted.begin() + size, key) - sorted.begin();
+			REQUIRE(branchlessLowerBound(sorted.data(), size, key, std::less<int>()) == expected);
+		}
+	}
+}
+
+TEST_CASE("FlatMap stores values next to sorted keys")
+{
+	FlatMap<int, std::string> map;
+	map.insert(3, "three");
+	map.insert(1, "one");
+	map[2] = "two";
+
+	SECTION("Lookups")
+	{
+		REQUIRE(map.getSize() == 3);
+		REQUIRE(map.at(1) == "one");
+		REQUIRE(map[2] == "two");
+		REQUIRE(map.getKey(2) == 3);
+		REQUIRE(map.insert(3, "other") == false);
+		REQUIRE(map.at(3) == "three");
+		REQUIRE_THROWS_AS(map.at(4), std::out_of_range);
+	}
+
+	SECTION("Batch insert() keeps existing values and the first of repeated keys")
+	{
+		DynamicArray<int> keys{ 5, 2, 4, 5 };
+		DynamicArray<std::string> values{ "five", "new two", "four", "second five" };
+		REQUIRE(map.insert(keys, values) == 2);
+
+		REQUIRE(map.getSize() == 5);
+		REQUIRE(map.at(2) == "two");
+		REQUIRE(map.at(4) == "four");
+		REQUIRE(map.at(5) == "five");
+		REQUIRE_THROWS_AS(map.insert(keys, DynamicArray<std::string>()), std::invalid_argument);
+	}
+
+	SECTION("Single and batch erase() keep keys and values together")
+	{
+		REQUIRE(map.erase(2) == true);
+		REQUIRE(map.erase(DynamicArray<int>{ 1, 7 }) == 1);
+		REQUIRE(map.getSize() == 1);
+		REQUIRE(map.getKey(0) == 3);
+		REQUIRE(map.getValue(0) == "three");
+	}
+}
+
+TEST_CASE("EytzingerIndex answers like a binary search over the sorted array")
+{
+	for (size_t size : { 0, 1, 2, 7, 8, 100, 1000 }) {
+		DynamicArray<int> sorted;
+		std::vector<int> expected;
+		for (size_t i = 0; i < size; ++i) {
+			sorted.push_back((int)(i / 2 * 3));
+			expected.push_back((int)(i / 2 * 3));
+		}
+
+		EytzingerIndex<int> index(sorted);
+		REQUIRE(index.getSize() == size);
+
+		for (int key = -2; key < (int)(size * 2); ++key) {
+			REQUIRE(index.lower_bound(key) == (size_t)(std::lower_bound(expected.begin(), expected.end(), key) - expected.begin()));
+			REQUIRE(index.upper_bound(key) == (size_t)(std::upper_bound(expected.begin(), expected.end(), key) - expected.begin()));
+		}
+
+		for (size_t i = 0; i < size; ++i)
+			REQUIRE(index.getSorted(i) == expected[i]);
+	}
+}
+
+TEST_CASE("EytzingerIndex range queries")
+{
+	DynamicArray<int> sorted{ 1, 3, 3, 5, 8, 13, 21 };
+	EytzingerIndex<int> index(sorted);
+
+	REQUIRE(index.count(3, 8) == 4);
+	REQUIRE(index.count(4, 4) == 0);
+	REQUIRE(index.count(0, 100) == 7);
+	REQUIRE(index.count(9, 2) == 0);
+}
+
+TEST_CASE("FlatHashMap agrees with std::unordered_map")
+{
+	FlatHashMap<int, int> map;
+	std::unordered_map<int, int> expected;
+
+	// Inserts, overwrites and erases mixed, so the table grows and reuses deleted slots
+	unsigned state = 12345;
+	for (int i = 0; i < 20000; ++i) {
+		state = state * 1103515245 + 12345;
+		int key = (int)(state >> 16) % 3000;
+
+		if (i % 3 == 2) {
+			REQUIRE(map.erase(key) == (expected.erase(key) == 1));
+		}
+		else {
+			REQUIRE(map.insert(key, i) == expected.emplace(key, i).second);
+		}
+	}
+
+	REQUIRE(map.getSize() == expected.size());
+	for (int key = -10; key < 3010; ++key) {
+		auto it = expected.find(key);
+		const int* value = map.find(key);
+		REQUIRE((value != nullptr) == (it != expected.end()));
+		if (value)
+			REQUIRE(*value == it->second);
+	}
+
+	size_t visited = 0;
+	map.forEach([&](int key, int value) {
+		REQUIRE(expected.at(key) == value);
+		++visited;
+	});
+	REQUIRE(visited == expected.size());
+}
+
+TEST_CASE("FlatHashMap access and copies")
+{
+	FlatHashMap<std::string, int> map;
+	map["one"] = 1;
+	map["two"] = 2;
+	map.insert("three", 3);
+
+	SECTION("Lookups")
+	{
+		REQUIRE(map.getSize() == 3);
+		REQUIRE(map.at("one") == 1);
+		REQUIRE(map["two"] == 2);
+		REQUIRE(map.contains("three") == true);
+		REQUIRE(map.insert("three", 4) == false);
+		REQUIRE(map.at("three") == 3);
+		REQUIRE_THROWS_AS(map.at("four"), std::out_of_range);
+		REQUIRE(map.find("four") == nullptr);
+		REQUIRE(FlatHashMap<int, int>().contains(1) == false);
+	}
+
+	SECTION("Copies are independent")
+	{
+		FlatHashMap<std::string, int> copy(map);
+		copy["one"] = 10;
+		copy.erase("two");
+
+		REQUIRE(map.at("one") == 1);
+		REQUIRE(map.contains("two") == true);
+
+		map = copy;
+		REQUIRE(map.getSize() == 2);
+		REQUIRE(map.at("one") == 10);
+		REQUIRE(map.contains("two") == false);
+	}
+
+	SECTION("reserve() prevents growth")
+	{
+		FlatHashMap<int, int> reserved(1000);
+		size_t capacity = reserved.getCapacity();
+		for (int i = 0; i < 1000; ++i)
+			reserved[i] = i;
+
+		REQUIRE(reserved.getCapacity() == capacity);
+		REQUIRE(reserved.getSize() == 1000);
+	}
+
+	SECTION("Erasing and inserting does not grow the table")
+	{
+		FlatHashMap<int, int> churn;
+		for (int i = 0; i < 10; ++i)
+			churn[i] = i;
+
+		size_t capacity = churn.getCapacity();
+		for (int i = 10; i < 10000; ++i) {
+			churn.erase(i - 10);
+			churn[i] = i;
+		}
+
+		REQUIRE(churn.getCapacity() == capacity);
+		REQUIRE(churn.getSize() == 10);
+		REQUIRE(churn.at(9999) == 9999);
+	}
+}
+
+TEST_CASE("SlotMap handles stay valid while other elements are erased")
+{
+	SlotMap<std::string> map;
+	auto a = map.insert("a");
+	auto b = map.insert("b");
+	auto c = map.insert("c");
+
+	SECTION("Lookups")
+	{
+		REQUIRE(map.getSize() == 3);
+		REQUIRE(map.at(a) == "a");
+		REQUIRE(*map.find(c) == "c");
+		REQUIRE(map.contains(SlotMap<std::string>::Handle()) == false);
+		REQUIRE_THROWS_AS(map.at(SlotMap<std::string>::Handle()), std::out_of_range);
+	}
+
+	SECTION("Erase keeps the elements packed")
+	{
+		REQUIRE(map.erase(a) == true);
+		REQUIRE(map.erase(a) == false);
+		REQUIRE(map.getSize() == 2);
+		REQUIRE(map.contains(a) == false);
+		REQUIRE(map.at(b) == "b");
+		REQUIRE(map.at(c) == "c");
+
+		for (size_t i = 0; i < map.getSize(); ++i)
+			REQUIRE(map.at(map.getHandle(i)) == map[i]);
+	}
+
+	SECTION("Reused slots do not revive old handles")
+	{
+		map.erase(b);
+		auto d = map.insert("d");
+
+		REQUIRE(d.index == b.index);
+		REQUIRE(d != b);
+		REQUIRE(map.find(b) == nullptr);
+		REQUIRE(map.at(d) == "d");
+	}
+}
+
+TEST_CASE("SlotMap agrees with a map of handles")
+{
+	SlotMap<int> map;
+	std::vector<std::pair<SlotMap<int>::Handle, int>> live;
+	std::vector<SlotMap<int>::Handle> dead;
+
+	unsigned state = 7;
+	for (int i = 0; i < 5000; ++i) {
+		state = state * 1103515245 + 12345;
+		if (live.empty() || (state >> 16) % 3 != 0) {
+			live.push_back({ map.insert(i), i });
+		}
+		else {
+			size_t victim = (state >> 8) % live.size();
+			REQUIRE(map.erase(live[victim].first) == true);
+			dead.push_back(live[victim].first);
+			live[victim] = live.back();
+			live.pop_back();
+		}
+	}
+
+	REQUIRE(map.getSize() == live.size());
+	for (const auto& entry : live)
+		REQUIRE(map.at(entry.first) == entry.second);
+	for (const auto& handle : dead)
+		REQUIRE(map.contains(handle) == false);
+}
+
+TEST_CASE("SparseArray allocates and releases pages on demand")
+{
+	SparseArray<int> arr;
+	const uint32_t pageSize = (uint32_t)SparseArray<int>::PAGE_SIZE;
+
+	arr.set(5, 50);
+	arr.set(6, 60);
+	arr[4000000000u] = 4;
+
+	SECTION("Lookups")
+	{
+		REQUIRE(arr.getSize() == 3);
+		REQUIRE(arr.getPageCount() == 2);
+		REQUIRE(arr.at(5) == 50);
+		REQUIRE(arr.at(4000000000u) == 4);
+		REQUIRE(arr.contains(7) == false);
+		REQUIRE(arr.find(pageSize * 3) == nullptr);
+		REQUIRE_THROWS_AS(arr.at(7), std::out_of_range);
+	}
+
+	SECTION("Erasing the last id of a page releases it")
+	{
+		REQUIRE(arr.erase(5) == true);
+		REQUIRE(arr.erase(5) == false);
+		REQUIRE(arr.getPageCount() == 2);
+		REQUIRE(arr.erase(6) == true);
+		REQUIRE(arr.getPageCount() == 1);
+		REQUIRE(arr.erase(4000000000u) == true);
+		REQUIRE(arr.getPageCount() == 0);
+		REQUIRE(arr.empty() == true);
+	}
+
+	SECTION("forEach() visits ids in order and copies are independent")
+	{
+		SparseArray<int> copy(arr);
+		copy.set(pageSize + 1, 1);
+		arr.erase(6);
+
+		std::vector<uint32_t> ids;
+		copy.forEach([&](uint32_t id, int) { ids.push_back(id); });
+		REQUIRE(ids == std::vector<uint32_t>{ 5, 6, pageSize + 1, 4000000000u });
+		REQUIRE(arr.getSize() == 2);
+	}
+}
+
+TEST_CASE("SparseSet keeps its entries packed")
+{
+	SparseSet<int> set;
+	std::unordered_map<uint32_t, int> expected;
+
+	unsigned state = 99;
+	for (int i = 0; i < 5000; ++i) {
+		state = state * 1103515245 + 12345;
+		uint32_t id = (state >> 8) % 2000 * 100003u;
+
+		if (i % 3 == 2) {
+			REQUIRE(set.erase(id) == (expected.erase(id) == 1));
+		}
+		else {
+			REQUIRE(set.insert(id, i) == expected.emplace(id, i).second);
+		}
+	}
+
+	REQUIRE(set.getSize() == expected.size());
+	for (size_t i = 0; i < set.getSize(); ++i) {
+		REQUIRE(expected.at(set.getIds()[i]) == set.getValues()[i]);
+		REQUIRE(set.at(set.getIds()[i]) == set.getValues()[i]);
+	}
+
+	for (const auto& entry : expected)
+		set.erase(entry.first);
+	REQUIRE(set.empty() == true);
+	REQUIRE(set.getPageCount() == 0);
+	REQUIRE(set[7] == 0);
+}
+
+TEST_CASE("Large arrays which ask for it are allocated in huge pages")
+{
+	SECTION("Trivial elements")
+	{
+		DynamicArray<int> arr;
+		REQUIRE_FALSE(arr.getHugePages());
+		arr.setHugePages(true);
+		REQUIRE(arr.getHugePages());
+		arr.reserve(3000000);
+
+		REQUIRE((size_t)arr.getData() % HUGE_PAGE_SIZE == 0);
+		REQUIRE(arr.getCapacity() == 3000000);
+
+		for (int i = 0; i < 3000000; ++i)
+			arr.push_back(i);
+		arr.push_back(-1);
+		arr.resize(10);
+		arr.shrink_to_fit();
+
+		REQUIRE(arr.getCapacity() == 10);
+		REQUIRE(arr[9] == 9);
+	}
+
+	SECTION("Elements with constructors")
+	{
+		DynamicArray<std::string> arr;
+		arr.setHugePages(true);
+		for (int i = 0; i < 300000; ++i)
+			arr.push_back(std::to_string(i));
+
+		REQUIRE(arr.getCapacity() * sizeof(std::string) >= HUGE_PAGE_THRESHOLD);
+		REQUIRE(arr[123456] == "123456");
+
+		DynamicArray<std::string> copy(arr);
+		REQUIRE(copy.back() == "299999");
+	}
+
+	struct Record { int fields[5]; };
+
+	SECTION("Capacity is not rounded up for sizes which do not divide the huge page size")
+	{
+		Container<Record> container;
+		container.setHugePages(true);
+		container.reserve(0, 250000);
+		REQUIRE(sizeof(Record) * 250000 >= HUGE_PAGE_THRESHOLD);
+		REQUIRE((size_t)container.getData() % HUGE_PAGE_SIZE == 0);
+		REQUIRE(container.getCap() == 250000);
+
+		DynamicArray<Record> arr;
+		arr.setHugePages(true);
+		arr.reserve(250000);
+		REQUIRE(arr.getCapacity() == 250000);
+	}
+
+	SECTION("SoaArray columns of different element sizes")
+	{
+		SoaArray<double, char> soa;
+		soa.reserve(600000);
+		REQUIRE(soa.getCapacity() == 600000);
+
+		size_t capacity = soa.getCapacity();
+		for (size_t i = 0; i < capacity; ++i)
+			soa.push_back((double)i, (char)(i % 100));
+		REQUIRE(soa.get<1>(capacity - 1) == (char)((capacity - 1) % 100));
+		REQUIRE(soa.get<0>(capacity - 1) == (double)(capacity - 1));
+	}
+
+	SECTION("RingArray of elements whose size is not a power of two")
+	{
+		RingArray<Record> ring;
+		ring.reserve(200000);
+		REQUIRE((ring.getCapacity() & (ring.getCapacity() - 1)) == 0);
+
+		for (int i = 0; i < 200000; ++i)
+			ring.push_back(Record{ { i, 0, 0, 0, -i } });
+		for (int i = 0; i < 1000; ++i) {
+			ring.pop_front();
+			ring.push_back(Record{ { 200000 + i, 0, 0, 0, 0 } });
+		}
+		for (size_t i = 0; i < ring.getSize(); ++i)
+			REQUIRE(ring[i].fields[0] == (int)i + 1000);
+	}
+}
+
+TEST_CASE("Placement policies keep the contents of large arrays")
+{
+	for (Placement placement : { Placement::Local, Placement::Interleaved, Placement::Partitioned }) {
+		DynamicArray<int> arr;
+		arr.setPlacement(placement, 4);
+		REQUIRE(arr.getPlacement() == placement);
+
+		arr.resize(2000000, 7);
+		for (int i = 0; i < 1000; ++i)
+			arr[i] = -i;
+		arr.reserve(5000000);
+
+		DynamicArray<int> copy;
+		copy.setPlacement(placement, 3);
+		copy = arr;
+
+		REQUIRE(copy.getSize() == 2000000);
+		REQUIRE(copy[999] == -999);
+		REQUIRE(copy[1000] == 7);
+		REQUIRE(copy.back() == 7);
+		REQUIRE(std::count(copy.getData(), copy.getData() + copy.getSize(), 7) == 2000000 - 1000);
+	}
+}
+
+//! Element whose copy assignment fails after a given number of copies
+struct ThrowingCopy
+{
+	static int copiesLeft;
+	int value = 0;
+
+	ThrowingCopy& operator=(const ThrowingCopy& other)
+	{
+		if (copiesLeft-- == 0)
+			throw std::runtime_error("Copy failed\n");
+		value = other.value;
+		return *this;
+	}
+};
+
+int ThrowingCopy::copiesLeft = 0;
+
+TEST_CASE("Throwing copies of large arrays reach the caller with every placement")
+{
+	for (Placement placement : { Placement::Local, Placement::Interleaved, Placement::Partitioned }) {
+		DynamicArray<ThrowingCopy> arr;
+		arr.setPlacement(placement, 4);
+		ThrowingCopy::copiesLeft = 2000000;
+		arr.resize(2000000, ThrowingCopy());
+
+		DynamicArray<ThrowingCopy> copy;
+		copy.setPlacement(placement, 4);
+		ThrowingCopy::copiesLeft = 1000;
+		REQUIRE_THROWS_AS(copy = arr, std::runtime_error);
+	}
+}
+
+TEST_CASE("parallelFor() covers the range once")
+{
+	for (size_t count : { 0, 1, 5, 1000 }) {
+		std::vector<int> hits(count, 0);
+		parallelFor(count, 4, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				++hits[i];
+		});
+		REQUIRE(std::count(hits.begin(), hits.end(), 1) == (long)count);
+	}
+}
+
+TEST_CASE("Streaming stores write the same data as plain stores")
+{
+	std::vector<unsigned char> source(1000);
+	for (size_t i = 0; i < source.size(); ++i)
+		source[i] = (unsigned char)(i * 7);
+
+	SECTION("streamCopy() with unaligned ends")
+	{
+		for (size_t offset : { 0, 1, 5, 16 }) {
+			for (size_t bytes : { 0, 3, 16, 17, 500 }) {
+				std::vector<unsigned char> target(600, 0);
+				streamCopy(target.data() + offset, source.data() + 3, bytes);
+
+				REQUIRE(std::equal(source.begin() + 3, source.begin() + 3 + bytes, target.begin() + offset));
+				REQUIRE(std::count(target.begin(), target.begin() + offset, 0) == (long)offset);
+				REQUIRE(std::count(target.begin() + offset + bytes, target.end(), 0) == (long)(600 - offset - bytes));
+			}
+		}
+	}
+
+	SECTION("streamFill() for different element sizes")
+	{
+		std::vector<int16_t> shorts(101, 0);
+		streamFill(shorts.data() + 1, 99, (int16_t)-3);
+		REQUIRE(shorts[0] == 0);
+		REQUIRE(shorts[100] == 0);
+		REQUIRE(std::count(shorts.begin(), shorts.end(), -3) == 99);
+
+		struct Triple { char a, b, c; };
+		std::vector<Triple> triples(50, Triple{ 0, 0, 0 });
+		streamFill(triples.data(), 50, Triple{ 1, 2, 3 });
+		REQUIRE(triples[49].c == 3);
+	}
+
+	SECTION("Large resize() and copy")
+	{
+		DynamicArray<int> arr;
+		arr.push_back(1);
+		arr.resize(9000000, 5);
+		DynamicArray<int> copy(arr);
+
+		REQUIRE(copy[0] == 1);
+		REQUIRE(std::count(copy.getData(), copy.getData() + copy.getSize(), 5) == 9000000 - 1);
+	}
+}
+
+TEST_CASE("gather() and scatter() match indexed loops")
+{
+	DynamicArray<int64_t> wide;
+	DynamicArray<int> narrow;
+	DynamicArray<std::string> strings;
+	for (int i = 0; i < 5000; ++i) {
+		wide.push_back((int64_t)i * 1000000007);
+		narrow.push_back(i * 3);
+		strings.push_back(std::to_string(i));
+	}
+
+	DynamicArray<size_t> indices;
+	unsigned state = 5;
+	for (int i = 0; i < 20003; ++i) {
+		state = state * 1103515245 + 12345;
+		indices.push_back((state >> 8) % 5000);
+	}
+
+	SECTION("Gather")
+	{
+		DynamicArray<int64_t> wideOut;
+		DynamicArray<int> narrowOut{ 1, 2, 3 };
+		DynamicArray<std::string> stringOut;
+		wide.gather(indices, wideOut);
+		narrow.gather(indices, narrowOut, 0);
+		strings.gather(indices, stringOut);
+
+		DynamicArray<int> sortedOut;
+		narrow.gatherSorted(indices, sortedOut);
+
+		REQUIRE(narrowOut.getSize() == indices.getSize());
+		for (size_t i = 0; i < indices.getSize(); ++i) {
+			REQUIRE(wideOut[i] == wide[indices[i]]);
+			REQUIRE(narrowOut[i] == narrow[indices[i]]);
+			REQUIRE(stringOut[i] == strings[indices[i]]);
+			REQUIRE(sortedOut[i] == narrow[indices[i]]);
+		}
+	}
+
+	SECTION("Scatter keeps the last of repeated indices")
+	{
+		DynamicArray<int> values;
+		for (size_t i = 0; i < indices.getSize(); ++i)
+			values.push_back((int)i);
+
+		std::vector<int> expected(narrow.getData(), narrow.getData() + narrow.getSize());
+		for (size_t i = 0; i < indices.getSize(); ++i)
+			expected[indices[i]] = values[i];
+
+		DynamicArray<int> sorted(narrow);
+		narrow.scatter(indices, values);
+		sorted.scatterSorted(indices, values);
+
+		requireSameElements(narrow, expected);
+		requireSameElements(sorted, expected);
+		REQUIRE_THROWS_AS(narrow.scatter(indices, DynamicArray<int>{ 1 }), std::invalid_argument);
+	}
+}
+
+TEST_CASE("Buffers are aligned to the Alignment parameter")
+{
+	struct alignas(64) CacheLine { int value; };
+
+	SECTION("Over-aligned element type")
+	{
+		DynamicArray<CacheLine> arr;
+		for (int i = 0; i < 100; ++i) {
+			arr.push_back(CacheLine{ i });
+			REQUIRE((size_t)arr.getData() % 64 == 0);
+		}
+		REQUIRE(arr[99].value == 99);
+	}
+
+	SECTION("Explicit alignment survives growth, copies and shrinking")
+	{
+		DynamicArray<float, 32> arr;
+		for (int i = 0; i < 1000; ++i) {
+			arr.push_back((float)i);
+			REQUIRE((size_t)arr.getData() % 32 == 0);
+		}
+
+		DynamicArray<float, 32> copy(arr);
+		copy.resize(10);
+		copy.shrink_to_fit();
+		REQUIRE((size_t)copy.getData() % 32 == 0);
+		REQUIRE(copy[9] == 9.0f);
+	}
+
+	SECTION("Elements with constructors")
+	{
+		DynamicArray<std::string, 4096> arr{ "a", "b" };
+		arr.push_back(std::string(100, 'c'));
+		for (int i = 0; i < 50; ++i)
+			arr.push_back(std::to_string(i));
+
+		REQUIRE((size_t)arr.getData() % 4096 == 0);
+		REQUIRE(arr[2] == std::string(100, 'c'));
+		REQUIRE(arr.back() == "49");
+	}
+
+	SECTION("Elements with destructors at a small alignment")
+	{
+		// new[] of such elements stores a cookie before them, which would break the alignment
+		struct Counted { int value = 0; ~Counted() { value = -1; } };
+
+		DynamicArray<std::string, 16> strings;
+		DynamicArray<Counted, 16> counted;
+		for (int i = 0; i < 100; ++i) {
+			strings.push_back(std::to_string(i));
+			counted.push_back(Counted());
+			REQUIRE((size_t)strings.getData() % 16 == 0);
+			REQUIRE((size_t)counted.getData() % 16 == 0);
+		}
+
+		DynamicArray<std::string, 16> copy(strings);
+		copy.resize(10);
+		copy.shrink_to_fit();
+		REQUIRE((size_t)copy.getData() % 16 == 0);
+		REQUIRE(copy[9] == "9");
+		REQUIRE(strings.back() == "99");
+	}
+}
+
+#ifdef DYNAMIC_ARRAY_HAS_CONSTEXPR
+constexpr std::array<int, 10> buildSquares()
+{
+	DynamicArray<int> arr;
+	for (int i = 0; i < 10; ++i)
+		arr.push_back(i * i);
+
+	arr.resize(12, -1);
+	arr.pop_back();
+	DynamicArray<int> copy(arr);
+	copy.resize(10);
+	copy.shrink_to_fit();
+
+	std::array<int, 10> table{};
+	for (size_t i = 0; i < copy.getSize(); ++i)
+		table[i] = copy.at(i);
+	return table;
+}
+
+TEST_CASE("DynamicArray builds tables at compile time")
+{
+	constexpr std::array<int, 10> squares = buildSquares();
+	static_assert(squares[9] == 81, "Built during constant evaluation");
+
+	for (int i = 0; i < 10; ++i)
+		REQUIRE(squares[i] == i * i);
+}
+#endif
+
+static_assert(std::is_trivially_copyable<InplaceArray<int, 8>>::value, "Trivially copyable elements give a trivially copyable array");
+static_assert(!std::is_trivially_copyable<InplaceArray<std::string, 8>>::value, "Elements with copy constructors are copied one by one");
+
+TEST_CASE("InplaceArray has the DynamicArray interface without heap storage")
+{
+	InplaceArray<int, 4> arr{ 1, 2 };
+
+	SECTION("Access and capacity")
+	{
+		REQUIRE(sizeof(arr) == 4 * sizeof(int) + sizeof(size_t));
+		REQUIRE(arr.getSize() == 2);
+		REQUIRE(arr.getCapacity() == 4);
+		REQUIRE(arr.front() == 1);
+		REQUIRE(arr.back() == 2);
+		REQUIRE_THROWS_AS(arr.at(2), std::out_of_range);
+	}
+
+	SECTION("Growing past the capacity throws")
+	{
+		arr.push_back(3);
+		arr.resize(4, 9);
+		REQUIRE(arr[3] == 9);
+		REQUIRE_THROWS_AS(arr.push_back(5), std::length_error);
+		REQUIRE_THROWS_AS(arr.resize(5), std::length_error);
+		REQUIRE_THROWS_AS((InplaceArray<int, 1>{ 1, 2 }), std::length_error);
+	}
+
+	SECTION("pop_back() on an empty array throws")
+	{
+		arr.pop_back();
+		arr.pop_back();
+		REQUIRE(arr.empty() == true);
+		REQUIRE_THROWS_AS(arr.pop_back(), std::logic_error);
+	}
+}
+
+TEST_CASE("InplaceArray constructs and destroys only the used elements")
+{
+	InplaceArray<std::string, 8> arr;
+	arr.push_back(std::string(100, 'a'));
+	arr.resize(3, "b");
+
+	InplaceArray<std::string, 8> copy(arr);
+	copy.pop_back();
+	copy[0] = "c";
+
+	REQUIRE(arr.getSize() == 3);
+	REQUIRE(arr[0] == std::string(100, 'a'));
+	REQUIRE(copy.getSize() == 2);
+
+	arr = copy;
+	REQUIRE(arr.getSize() == 2);
+	REQUIRE(arr[0] == "c");
+
+	arr.resize(1);
+	REQUIRE(arr.back() == "c");
+}
+
+TEST_CASE("Reading directly into the tail of a DynamicArray")
+{
+	SECTION("Chunks from a file")
+	{
+		std::FILE* file = std::tmpfile();
+		REQUIRE(file != nullptr);
+		for (int i = 0; i < 1000; ++i)
+			std::fputc(i % 251, file);
+		std::rewind(file);
+
+		DynamicArray<unsigned char> arr;
+		size_t read = 0;
+		do {
+			Span<unsigned char> tail = arr.prepareTail(64);
+			read = std::fread(tail.getData(), 1, tail.getSize(), file);
+			arr.commitTail(read);
+		} while (read > 0);
+		std::fclose(file);
+
+		REQUIRE(arr.getSize() == 1000);
+		for (int i = 0; i < 1000; ++i)
+			REQUIRE(arr[i] == i % 251);
+	}
+
+	SECTION("Partial commits keep the earlier elements")
+	{
+		DynamicArray<int> arr{ 1, 2 };
+		Span<int> tail = arr.prepareTail(10);
+		REQUIRE(tail.getSize() == 10);
+		REQUIRE(arr.getCapacity() >= 12);
+
+		tail[0] = 3;
+		arr.commitTail(1);
+		requireSameElements(arr, { 1, 2, 3 });
+		REQUIRE_THROWS_AS(arr.commitTail(arr.getCapacity()), std::out_of_range);
+	}
+}
+
+TEST_CASE("Asynchronous save and load of DynamicArray contents")
+{
+	const char* path = "async_file_test.bin";
+	DynamicArray<int> arr;
+	for (int i = 0; i < 300000; ++i)
+		arr.push_back(i * 7);
+
+	SECTION("Round trip in small chunks")
+	{
+		IoOptions options;
+		options.chunkSize = 4096;
+		options.queueDepth = 8;
+
+		IoHandle saved = saveAsync(arr, path, options);
+		saved.wait();
+		REQUIRE(saved.isDone());
+		REQUIRE(saved.getBytes() == arr.getSize() * sizeof(int));
+		REQUIRE(saved.getThroughput() >= 0);
+
+		DynamicArray<int> loaded{ 1, 2, 3 };
+		IoHandle handle = loadAsync(loaded, path, options);
+		handle.wait();
+		REQUIRE(handle.getBytes() == arr.getSize() * sizeof(int));
+		REQUIRE(loaded.getSize() == arr.getSize());
+		REQUIRE(std::equal(arr.getData(), arr.getData() + arr.getSize(), loaded.getData()));
+	}
+
+	SECTION("Synchronous fallback")
+	{
+		IoOptions options;
+		options.chunkSize = 10000;
+		options.useIoUring = false;
+
+		IoHandle saved = saveAsync(arr, path, options);
+		saved.wait();
+		REQUIRE_FALSE(saved.usedIoUring());
+
+		DynamicArray<int> loaded;
+		IoHandle handle = loadAsync(loaded, path, options);
+		handle.wait();
+		REQUIRE_FALSE(handle.usedIoUring());
+		REQUIRE(std::equal(arr.getData(), arr.getData() + arr.getSize(), loaded.getData()));
+	}
+
+	SECTION("Direct transfers with an aligned buffer and an unaligned tail")
+	{
+		DynamicArray<int, DIRECT_IO_ALIGNMENT> aligned;
+		for (int i = 0; i < 5000; ++i)
+			aligned.push_back(-i);
+
+		IoOptions options;
+		options.chunkSize = 2 * DIRECT_IO_ALIGNMENT;
+		options.direct = true;
+		saveAsync(aligned, path, options).wait();
+
+		DynamicArray<int, DIRECT_IO_ALIGNMENT> loaded;
+		loadAsync(loaded, path, options).wait();
+		REQUIRE(loaded.getSize() == 5000);
+		REQUIRE(std::equal(aligned.getData(), aligned.getData() + aligned.getSize(), loaded.getData()));
+
+		options.chunkSize = 1000;
+		REQUIRE_THROWS_AS(saveAsync(aligned, path, options), std::invalid_argument);
+	}
+
+	SECTION("Errors")
+	{
+		std::remove(path);
+		DynamicArray<int> loaded;
+		REQUIRE_THROWS_AS(loadAsync(loaded, path), std::runtime_error);
+
+		DynamicArray<char> odd{ 'a', 'b', 'c' };
+		saveAsync(odd, path).wait();
+		REQUIRE_THROWS_AS(loadAsync(loaded, path), std::runtime_error);
+
+		IoHandle unwritable = saveAsync(arr, "missing_directory/async_file_test.bin");
+		REQUIRE_THROWS_AS(unwritable.wait(), std::runtime_error);
+		REQUIRE(unwritable.isDone());
+		REQUIRE(unwritable.getBytes() == 0);
+	}
+
+	std::remove(path);
+}
+
+TEST_CASE("ExternalArray keeps a bounded window of pages in memory")
+{
+	ExternalArray<int> arr(100, 4);
+	REQUIRE(arr.empty());
+	for (int i = 0; i < 2000; ++i)
+		arr.push_back(i);
+
+	REQUIRE(arr.getSize() == 2000);
+	REQUIRE(arr.getPagesWritten() == 20);
+
+	SECTION("Sequential reads")
+	{
+		for (int i = 0; i < 2000; ++i)
+			REQUIRE(arr.get(i) == i);
+		REQUIRE(arr.getPagesRead() >= 16);
+	}
+
+	SECTION("Random updates survive eviction")
+	{
+		for (int i = 1999; i >= 0; i -= 7)
+			arr.set(i, -i);
+		for (int i = 0; i < 2000; ++i)
+			REQUIRE(arr.get(i) == ((1999 - i) % 7 == 0 ? -i : i));
+	}
+
+	SECTION("Appending after a partial page was evicted")
+	{
+		arr.push_back(2000);
+		arr.get(0);
+		arr.get(500);
+		arr.get(1000);
+		arr.get(1500);
+		arr.push_back(2001);
+		REQUIRE(arr.get(2000) == 2000);
+		REQUIRE(arr.get(2001) == 2001);
+	}
+
+	REQUIRE_THROWS_AS(arr.get(2000000), std::out_of_range);
+	REQUIRE_THROWS_AS(arr.set(2000000, 0), std::out_of_range);
+	REQUIRE_THROWS_AS(ExternalArray<int>(100, 1), std::invalid_argument);
+	REQUIRE_THROWS_AS(ExternalArray<int>(0, 4), std::invalid_argument);
+}
+
+TEST_CASE("External sort of files larger than the memory budget")
+{
+	const char* input = "external_sort_input.bin";
+	const char* output = "external_sort_output.bin";
+
+	DynamicArray<unsigned> values;
+	unsigned state = 12345;
+	for (int i = 0; i < 50000; ++i) {
+		state = state * 1103515245u + 12345u;
+		values.push_back(state >> 8);
+	}
+
+	std::FILE* file = std::fopen(input, "wb");
+	REQUIRE(file != nullptr);
+	std::fwrite(values.getData(), sizeof(unsigned), values.getSize(), file);
+	std::fclose(file);
+
+	auto readOutput = [output]() {
+		DynamicArray<unsigned> result;
+		std::FILE* file = std::fopen(output, "rb");
+		unsigned value;
+		while (std::fread(&value, sizeof(value), 1, file) == 1)
+			result.push_back(value);
+		std::fclose(file);
+		return result;
+	};
+
+	std::vector<unsigned> expected(values.getData(), values.getData() + values.getSize());
+	std::sort(expected.begin(), expected.end());
+
+	SECTION("Many runs")
+	{
+		ExternalSortOptions options;
+		options.memoryBytes = 8000;
+		options.threads = 4;
+		ExternalSortStats stats = externalSort<unsigned>(input, output, options);
+
+		REQUIRE(stats.elements == 50000);
+		REQUIRE(stats.runs == 50);
+		REQUIRE(stats.runPhase.bytesRead == 200000);
+		REQUIRE(stats.runPhase.bytesWritten == 200000);
+		REQUIRE(stats.mergePhase.bytesRead == 200000);
+		REQUIRE(stats.mergePhase.bytesWritten == 200000);
+
+		DynamicArray<unsigned> result = readOutput();
+		REQUIRE(result.getSize() == expected.size());
+		REQUIRE(std::equal(expected.begin(), expected.end(), result.getData()));
+	}
+
+	SECTION("Single run with a custom order")
+	{
+		ExternalSortStats stats = externalSort<unsigned>(input, output, ExternalSortOptions(), std::greater<unsigned>());
+		REQUIRE(stats.runs == 1);
+		REQUIRE(stats.mergePhase.bytesRead == 0);
+
+		DynamicArray<unsigned> result = readOutput();
+		REQUIRE(std::equal(expected.rbegin(), expected.rend(), result.getData()));
+	}
+
+	SECTION("Parallel sort of a DynamicArray")
+	{
+		sortParallel(values.getData(), values.getSize(), 3);
+		REQUIRE(std::equal(expected.begin(), expected.end(), values.getData()));
+	}
+
+	SECTION("Loser tree merges stably")
+	{
+		int first[] = { 1, 3, 5 };
+		int second[] = { 1, 2, 5, 6 };
+		LoserTree<int, std::less<int>> tree(2, std::less<int>());
+		tree.setHead(0, first);
+		tree.setHead(1, second);
+		tree.build();
+
+		const int* ends[] = { first + 3, second + 4 };
+		std::vector<size_t> order;
+		for (size_t winner = tree.getWinner(); tree.getHead(winner); winner = tree.getWinner()) {
+			order.push_back(winner);
+			const int* next = tree.getHead(winner) + 1;
+			tree.replaceWinner(next == ends[winner] ? nullptr : next);
+		}
+		REQUIRE(order == std::vector<size_t>({ 0, 1, 1, 0, 0, 1, 1 }));
+	}
+
+	REQUIRE_THROWS_AS(externalSort<unsigned>("missing_external_sort_input.bin", output), std::runtime_error);
+	std::remove(input);
+	std::remove(output);
+}
+
+TEST_CASE("Shrink policy releases memory with hysteresis")
+{
+	DynamicArray<int> arr;
+	for (int i = 0; i < 1000; ++i)
+		arr.push_back(i);
+	size_t peak = arr.getCapacity();
+
+	SECTION("The default never shrinks")
+	{
+		arr.resize(10);
+		while (!arr.empty())
+			arr.pop_back();
+		REQUIRE(arr.getCapacity() == peak);
+	}
+
+	SECTION("Shrinking below a quarter of the capacity")
+	{
+		arr.setShrinkPolicy(SHRINK_QUARTER);
+		while ((arr.getSize() - 1) * 4 >= peak)
+			arr.pop_back();
+		REQUIRE(arr.getCapacity() == peak);
+
+		arr.pop_back();
+		size_t size = arr.getSize();
+		REQUIRE(arr.getCapacity() == 2 * size);
+		for (size_t i = 0; i < size; ++i)
+			REQUIRE(arr[i] == (int)i);
+
+		// Moving around the new size neither shrinks nor grows
+		size_t capacity = arr.getCapacity();
+		for (int round = 0; round < 100; ++round) {
+			arr.push_back(0);
+			arr.pop_back();
+			arr.pop_back();
+			arr.push_back(0);
+		}
+		REQUIRE(arr.getCapacity() == capacity);
+
+		arr.resize(3);
+		REQUIRE(arr.getCapacity() == 6);
+		requireSameElements(arr, { 0, 1, 2 });
+		arr.resize(0);
+		REQUIRE(arr.getCapacity() == arr.getInitCap());
+	}
+
+	SECTION("Large buffers shrink only when they need fewer huge pages")
+	{
+		DynamicArray<char> large;
+		large.setHugePages(true);
+		large.resize((size_t)9 << 20);
+		large.setShrinkPolicy({ 0.5f, 1.9f });
+
+		// Below half the capacity 1.9 * size still rounds up to the same five huge pages
+		const char* buffer = large.getData();
+		while (large.getSize() > ((size_t)17 << 18))
+			large.pop_back();
+		REQUIRE(large.getData() == buffer);
+		REQUIRE(large.getCapacity() == (size_t)9 << 20);
+
+		while (large.getSize() > ((size_t)4 << 20))
+			large.pop_back();
+		REQUIRE(large.getCapacity() <= (size_t)8 << 20);
+		REQUIRE(large.getCapacity() >= large.getSize());
+	}
+
+	SECTION("Invalid policies")
+	{
+		REQUIRE_THROWS_AS(arr.setShrinkPolicy({ 1.0f, 2.0f }), std::invalid_argument);
+		REQUIRE_THROWS_AS(arr.setShrinkPolicy({ 0.25f, 1.0f }), std::invalid_argument);
+		REQUIRE_THROWS_AS(arr.setShrinkPolicy({ 0.5f, 2.0f }), std::invalid_argument);
+		REQUIRE(arr.getShrinkPolicy().threshold == 0);
+	}
+}